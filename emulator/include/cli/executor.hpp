@@ -25,6 +25,34 @@ namespace cli {
          */
         unsigned int runCycles(unsigned int count);
 
+        /**
+         * Execute instructions a basic block at a time (via Intel8086::run) rather than one instruction per cycle. Only
+         * a summary is logged, making this considerably faster than Executor::runCycles for long-running programs.
+         *
+         * @param count The maximum number of instructions to execute.
+         * @return Returns the number of instructions executed successfully.
+         */
+        unsigned int runBlocks(unsigned int count);
+
+        /**
+         * Enable translation of frequently executed blocks into native code when using Executor::runBlocks.
+         *
+         * @return Whether translation is supported on this platform (and so was enabled).
+         */
+        bool enableJit();
+
+        /**
+         * Wrap addresses around at 1 MiB (as on the 8086) and record, rather than throw upon, accesses beyond the end of
+         * memory (see Memory::WRAPPED_ACCESS). Memory accesses are otherwise checked.
+         */
+        void enableWrappedAccess();
+
+        /**
+         * Log the number of hits and misses recorded by the CPU's decoded instruction and basic block caches (as well as
+         * translation statistics should translation be enabled).
+         */
+        void logCacheStatistics() const;
+
     protected:
         emu::Memory<emu::MemValue, emu::AbsAddr> memory;
         emu::cpu::Intel8086 cpu;
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include "emu/types.hpp"
+#include "emu/cpu/instr/decodedinstruction.hpp"
+
+namespace emu::cpu {
+    /**
+     * A straight-line sequence of decoded instructions ending with either a control transfer instruction (or HLT), the
+     * maximum block length, or an instruction that could not be decoded.
+     */
+    struct BasicBlock {
+        /// Maximum number of instructions decoded into a single block.
+        static constexpr unsigned int MAX_LENGTH = 32;
+
+        u16 codeSegment = 0; /// Code segment value the block was decoded with.
+        OffsetAddr instructionPointer = 0; /// Instruction pointer value at the start of the block.
+
+        AbsAddr firstAddress = 0; /// Lowest absolute address of the memory the block was decoded from.
+        AbsAddr lastAddress = 0; /// Highest absolute address of the memory the block was decoded from.
+
+        unsigned int count = 0; /// Number of instructions in the block.
+        std::array<instr::DecodedInstruction, MAX_LENGTH> instructions;
+    };
+
+    /**
+     * Direct-mapped cache of basic blocks keyed by the CS:IP pair at which they begin. Like the DecodeCache, entries
+     * are validated against the write generation of the memory they were decoded from.
+     */
+    class BlockCache {
+    public:
+        /// Number of entries in the cache (must be a power of two).
+        static constexpr std::size_t ENTRY_COUNT = 1024;
+
+        /**
+         * Search the cache for a valid block beginning at CS:IP.
+         *
+         * @return Pointer to the cached block or nullptr should there be no valid entry.
+         */
+        const BasicBlock* lookup(u16 codeSegment, OffsetAddr instructionPointer, const Mem& memory);
+
+        /**
+         * Fetch the slot in which a block starting at CS:IP should be decoded. The slot is invalidated until the
+         * block has been decoded and BlockCache::commit is called.
+         */
+        BasicBlock& allocate(u16 codeSegment, OffsetAddr instructionPointer);
+
+        /**
+         * Mark a block previously returned by BlockCache::allocate as decoded and valid.
+         */
+        void commit(BasicBlock& block, const Mem& memory);
+
+        /**
+         * Check whether the memory a block was decoded from has been written to since it was decoded.
+         */
+        bool isStale(const BasicBlock& block, const Mem& memory) const;
+
+        /// Remove all blocks from the cache (hit/miss counters are unaffected).
+        void clear();
+
+        /// Number of lookups that found a valid block.
+        unsigned long getHits() const;
+        /// Number of lookups that did not find a valid block.
+        unsigned long getMisses() const;
+
+    private:
+        struct Entry {
+            u64 memoryId = 0; /// Identifier of the memory decoded from (see Memory::getId).
+            u32 generation = 0;
+            bool valid = false;
+            BasicBlock block;
+        };
+
+        static std::size_t getIndex(u16 codeSegment, OffsetAddr instructionPointer);
+
+        std::array<Entry, ENTRY_COUNT> entries;
+
+        unsigned long hits = 0, misses = 0;
+    };
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include "emu/types.hpp"
+#include "emu/cpu/instr/decodedinstruction.hpp"
+
+namespace emu::cpu {
+    /**
+     * Direct-mapped cache of decoded instructions keyed by the absolute 20-bit address they were fetched from. Allows
+     * instructions that are executed repeatedly (such as those within loops) to skip the decoding step entirely.
+     *
+     * Each entry records the write generation of the memory the instruction was decoded from. An entry is only
+     * considered a hit if that memory has not been written to since, which ensures that self-modifying code or code
+     * loaded over existing instructions is always decoded afresh.
+     */
+    class DecodeCache {
+    public:
+        /// Number of entries in the cache (must be a power of two).
+        static constexpr std::size_t ENTRY_COUNT = 4096;
+
+        /**
+         * Search the cache for a valid decoded instruction at the given address.
+         *
+         * @param address The absolute address of the instruction.
+         * @param memory The memory the instruction is to be fetched from.
+         * @return Pointer to the cached instruction or nullptr should there be no valid entry.
+         */
+        const instr::DecodedInstruction* lookup(AbsAddr address, const Mem& memory);
+
+        /**
+         * Store a decoded instruction in the cache, replacing any existing entry that maps to the same slot.
+         *
+         * @param address The absolute address the instruction was decoded from.
+         * @param memory The memory the instruction was decoded from.
+         * @param instruction The decoded instruction.
+         */
+        void insert(AbsAddr address, const Mem& memory, const instr::DecodedInstruction& instruction);
+
+        /// Remove all entries from the cache (hit/miss counters are unaffected).
+        void clear();
+
+        /// Number of lookups that found a valid entry.
+        unsigned long getHits() const;
+        /// Number of lookups that did not find a valid entry.
+        unsigned long getMisses() const;
+
+    private:
+        struct Entry {
+            AbsAddr address = 0;
+            AbsAddr lastAddress = 0; /// Address of the final byte of the instruction.
+            u64 memoryId = 0; /// Identifier of the memory decoded from (see Memory::getId).
+            u32 generation = 0;
+            bool valid = false;
+            instr::DecodedInstruction instruction;
+        };
+
+        std::array<Entry, ENTRY_COUNT> entries;
+
+        unsigned long hits = 0, misses = 0;
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "primitives.hpp"
+#include "emu/cpu/reg/lazyflags.hpp"
+
+namespace emu::cpu::instr {
+    /**
+     * Operations performed by the arithmetic/logic instruction groups. Ordered as encoded by bits 3 to 5 of the E, G
+     * opcodes (0x00 to 0x3B) and by the REG component of the immediate group opcodes (0x80 to 0x83).
+     */
+    enum AluFunction : u8 {
+        ADD_FUNCTION,
+        OR_FUNCTION,
+        ADC_FUNCTION,
+        SBB_FUNCTION,
+        AND_FUNCTION,
+        SUB_FUNCTION,
+        XOR_FUNCTION,
+        CMP_FUNCTION
+    };
+
+    constexpr unsigned int ALU_FUNCTION_COUNT = 8;
+
+    /**
+     * Returns the ALU function encoded by bits 3 to 5 of the given value.
+     */
+    constexpr AluFunction getEncodedAluFunction(u8 bits) {
+        return static_cast<AluFunction>((bits >> 3) & 0b111);
+    }
+
+    /**
+     * Returns the assembly mnemonic of an ALU function.
+     */
+    constexpr const char* getAluFunctionIdentifier(AluFunction function) {
+        constexpr const char* identifiers[ALU_FUNCTION_COUNT] = { "add", "or", "adc", "sbb", "and", "sub", "xor", "cmp" };
+        return identifiers[function];
+    }
+
+    /**
+     * Returns the rules by which an ALU function affects the status flags.
+     */
+    constexpr reg::AluOperation getFlagOperation(AluFunction function) {
+        switch(function) {
+        case ADD_FUNCTION: return reg::ADD_OPERATION;
+        case ADC_FUNCTION: return reg::ADC_OPERATION;
+        case SBB_FUNCTION: return reg::SBB_OPERATION;
+        case SUB_FUNCTION:
+        case CMP_FUNCTION: return reg::SUB_OPERATION;
+        default: return reg::LOGIC_OPERATION;
+        }
+    }
+
+    /**
+     * Returns whether the result of an ALU function is written to its destination (false for CMP, which only affects
+     * the flags).
+     */
+    constexpr bool writesResult(AluFunction function) {
+        return function != CMP_FUNCTION;
+    }
+}
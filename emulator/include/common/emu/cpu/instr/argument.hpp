@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include "primitives.hpp"
 #include "emu/cpu/instr/modregrm.hpp"
 #include "emu/types.hpp"
 #include "assembly.hpp"
@@ -9,41 +10,61 @@ namespace emu::cpu::instr {
     /**
      * Represents an additional argument to an instruction (either an immediate value or displacement value - not a
      * MOD-REG-R/M component or the opcode).
+     *
+     * The 1 or 2 raw bytes are stored inline alongside the zero- and sign-extended values (calculated upon
+     * construction) so that data arguments are trivially copyable and accessing their value never touches the heap.
      */
     class DataArgument {
     public:
         /**
-         * Create a data argument containing the specified raw data (little endian format).
+         * Create a data argument containing the specified raw data (little endian format). Only the first 2 bytes are
+         * used, and a single 0 byte is assumed should the data be empty.
          */
-        DataArgument(std::vector<u8> raw);
+        DataArgument(const std::vector<u8>& raw);
 
         /**
-         * Convert this instruction argument into assembly. This method is pure virtual but overriden in the Immediate
-         * and Displacement classes.
-         *
-         * @param size The data size handled by the instruction this data argument is a part of (usually indicated by
-         *        data size bit of instruction opcode).
-         * @param modRegRm Constant reference to the instruction's MOD-REG-R/M component.
+         * Create a single byte data argument.
          */
-        virtual std::string toAssembly(DataSize size, const ModRegRm& modRegRm, const reg::GeneralRegisters& registers,
-                                       const assembly::Style& style) const = 0;
+        constexpr DataArgument(u8 low) : rawData{ low, 0 }, rawSize(1), wordValue(low),
+                                         signExtendedValue(static_cast<u16>(static_cast<i8>(low))) {}
 
         /**
-         * Return a constant reference to the raw data of this data argument.
+         * Create a word data argument from its least and most significant bytes.
          */
-        const std::vector<u8>& getRawData() const;
+        constexpr DataArgument(u8 low, u8 high) : rawData{ low, high }, rawSize(2),
+                                                  wordValue(static_cast<u16>(high << 8 | low)),
+                                                  signExtendedValue(wordValue) {}
+
+        /**
+         * Return the raw data of this data argument. Involves heap allocation so should be avoided on the hot path.
+         */
+        std::vector<u8> getRawData() const;
+
+        /**
+         * Returns the number of bytes of raw data (1 or 2).
+         */
+        constexpr u8 getSize() const { return rawSize; }
 
         /**
          * Will return the value of this immediate instruction component as either 8-bits or 16-bits (note the return
          * value will be cast to u16 regardless) based on the data size specified.
          */
-        u16 getValueUsingDataSize(DataSize size) const;
+        constexpr u16 getValueUsingDataSize(DataSize size) const {
+            return size == WORD_DATA_SIZE ? wordValue : rawData[0];
+        }
+
+        constexpr u8 getByteValue() const { return rawData[0]; }
+        constexpr u16 getWordValue() const { return wordValue; } /// High byte is 0 for single byte data arguments.
 
-        u8 getByteValue() const;
-        u16 getWordValue() const;
+        /**
+         * Returns the value sign-extended to 16 bits (the same as the word value for 2 byte data arguments).
+         */
+        constexpr u16 getSignExtendedValue() const { return signExtendedValue; }
 
     private:
-        std::vector<u8> rawData;
+        u8 rawData[2];
+        u8 rawSize;
+        u16 wordValue, signExtendedValue;
     };
 
 
@@ -52,8 +73,14 @@ namespace emu::cpu::instr {
     public:
         using DataArgument::DataArgument;
 
+        /**
+         * Convert this immediate value into assembly.
+         *
+         * @param size The data size handled by the instruction this data argument is a part of (usually indicated by
+         *        data size bit of instruction opcode).
+         */
         std::string toAssembly(DataSize size, const ModRegRm&, const reg::GeneralRegisters&,
-                               const assembly::Style& style) const override final;
+                               const assembly::Style& style) const;
     };
 
 
@@ -62,24 +89,35 @@ namespace emu::cpu::instr {
     public:
         using DataArgument::DataArgument;
 
+        /**
+         * Convert this displacement into assembly.
+         *
+         * @param modRegRm Constant reference to the instruction's MOD-REG-R/M component.
+         */
         std::string toAssembly(DataSize, const ModRegRm& modRegRm, const reg::GeneralRegisters& registers,
-                               const assembly::Style& style) const override final;
+                               const assembly::Style& style) const;
 
         /**
          * Gives the displacement value of this displacement component based on the given addressing mode (either byte
-         * or word displacement).
+         * or word displacement). Byte displacements are sign-extended.
          */
-        u16 getValueUsingAddressingMode(AddressingMode mode) const;
+        constexpr u16 getValueUsingAddressingMode(AddressingMode mode) const {
+            switch(mode) {
+            case BYTE_DISPLACEMENT: return getSignExtendedValue();
+            case WORD_DISPLACEMENT: return getWordValue();
+            default: return 0; // Invalid addressing mode so just return 0.
+            }
+        }
 
         /**
-         * Returns an absolute memory address based on the displacement value and displacement type.
+         * Returns the offset of a memory operand (within the default segment of its addressing mode) based on the
+         * displacement value and the effective address kernel of the given addressing mode and displacement type.
          *
-         * @param mode The addressing mode specified by the MOD-REG-R/M byte (note that register addressing mode will
-         *        be treated the same as no displacement).
+         * @param mode The addressing mode specified by the MOD-REG-R/M byte (must not be register addressing mode).
          * @param type The displacement type as specified by the MOD-REG-R/M byte.
          * @param registers The general-purpose and indexing CPU registers.
-         * @return The resolved absolute memory address.
+         * @return The resolved offset.
          */
-        AbsAddr resolve(AddressingMode mode, DisplacementType type, reg::GeneralRegisters& registers) const;
+        OffsetAddr resolve(AddressingMode mode, DisplacementType type, const reg::GeneralRegisters& registers) const;
     };
 }
\ No newline at end of file
@@ -1,14 +1,27 @@
 #pragma once
 
 #include "emu/cpu/instr/complexinstruction.hpp"
+#include "emu/cpu/instr/alu.hpp"
 
 namespace emu::cpu::instr {
-    class AddEG : public ComplexInstructionEG {
+    /**
+     * ADD, OR, ADC, SBB, AND, SUB, XOR or CMP taking E, G arguments (opcodes 0x00 to 0x3B).
+     */
+    class ArithmeticLogicEG : public ComplexInstructionEG {
     public:
-        AddEG(Opcode instrOpcode, ModRegRm instrModRegRm,
-              std::optional<Displacement> displacement = {}, std::optional<Immediate> immediate = {});
+        ArithmeticLogicEG(AluFunction aluFunction, Opcode instrOpcode, ModRegRm instrModRegRm,
+                          std::optional<Displacement> displacement = {}, std::optional<Immediate> immediate = {});
 
     protected:
-        u16 performOperation(u16 dest, u16 src) override final;
+        u16 performOperation(Intel8086& cpu, DataSize size, u16 dest, u16 src) override final;
+
+    private:
+        const AluFunction function;
+    };
+
+    class AddEG : public ArithmeticLogicEG {
+    public:
+        AddEG(Opcode instrOpcode, ModRegRm instrModRegRm,
+              std::optional<Displacement> displacement = {}, std::optional<Immediate> immediate = {});
     };
 }
\ No newline at end of file
@@ -11,7 +11,7 @@ namespace emu::cpu::instr {
      */
     class ComplexInstruction : public Instruction {
     public:
-        ComplexInstruction(std::string instrIdentifier, Opcode instrOpcode, ModRegRm instrModRegRm,
+        ComplexInstruction(const char* instrIdentifier, Opcode instrOpcode, ModRegRm instrModRegRm,
                            std::optional<Displacement> displacement = {}, std::optional<Immediate> immediate = {});
 
         OffsetAddr execute(Intel8086& cpu, Mem& memory) override final;
@@ -87,12 +87,23 @@ namespace emu::cpu::instr {
         std::string argumentsToAssemblySpecifiedDisplacement(const Intel8086& cpu, const assembly::Style& style,
                                                              const Displacement& specifiedDisplacement) const;
 
-        void executeNoDisplacement(Intel8086&, Mem&) override final {};
-        void executeByteDisplacement(Intel8086&, Mem&) override final {};
-        void executeWordDisplacement(Intel8086&, Mem&) override final {};
+        void executeNoDisplacement(Intel8086& cpu, Mem& memory) override final;
+        void executeByteDisplacement(Intel8086& cpu, Mem& memory) override final;
+        void executeWordDisplacement(Intel8086& cpu, Mem& memory) override final;
         void executeRegisterAddressingMode(Intel8086& cpu, Mem&) override final;
 
-        virtual u16 performOperation(u16 dest, u16 src) = 0;
+        /**
+         * Execute this instruction with a memory operand addressed by the MOD and R/M components and displacement.
+         */
+        void executeMemoryAddressingMode(Intel8086& cpu, Mem& memory);
+
+        /**
+         * Perform the operation of the instruction, recording its effect on the CPU flags.
+         *
+         * @param size Width of the operands.
+         * @return The result to be written to the destination operand.
+         */
+        virtual u16 performOperation(Intel8086& cpu, DataSize size, u16 dest, u16 src) = 0;
     };
 
     /**
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "primitives.hpp"
+#include "assembly.hpp"
+#include "emu/types.hpp"
+#include "emu/cpu/instr/instruction.hpp"
+#include "emu/cpu/instr/alu.hpp"
+
+namespace emu::cpu::instr {
+    /// Number of E, G handlers for each kind of operand (one per ALU function, data size and direction).
+    constexpr unsigned int EG_HANDLER_VARIANTS = ALU_FUNCTION_COUNT * 2 * 2;
+
+    /**
+     * Pairs of consecutive instructions that are fused into a single handler when decoding blocks (see
+     * Intel8086::setPairFusion).
+     */
+    enum FusedPair : u8 {
+        PUSH_PUSH_PAIR, /// PUSH register followed by PUSH register.
+        POP_POP_PAIR, /// POP register followed by POP register.
+        PUSH_POP_PAIR, /// PUSH register followed by POP register (i.e. a register move via the stack).
+        FUSED_PAIR_COUNT
+    };
+
+    /**
+     * Identifies the routine responsible for executing a decoded instruction. Instructions taking a MOD-REG-R/M byte
+     * have separate handlers for each data size, direction and for register/memory operands so that none of these
+     * need to be checked at execution time.
+     */
+    enum HandlerId : u8 {
+        INVALID_HANDLER,
+        PUSH_REGISTER_HANDLER,
+        POP_REGISTER_HANDLER,
+        HALT_HANDLER,
+        PUSH_FLAGS_HANDLER,
+        POP_FLAGS_HANDLER,
+        LOAD_AH_FROM_FLAGS_HANDLER,
+        STORE_AH_INTO_FLAGS_HANDLER,
+        EG_REGISTER_HANDLERS, /// First of the E, G handlers taking a register operand (see getEGHandler).
+        EG_MEMORY_HANDLERS = EG_REGISTER_HANDLERS + EG_HANDLER_VARIANTS, /// First of those taking a memory operand.
+        FUSED_PAIR_HANDLERS = EG_MEMORY_HANDLERS + EG_HANDLER_VARIANTS, /// First of the handlers of FusedPair values.
+        HANDLER_COUNT = FUSED_PAIR_HANDLERS + FUSED_PAIR_COUNT
+    };
+
+    /**
+     * Returns the identifier of the E, G handler for the given combination of operand kind, function, data size and
+     * direction. Handlers are ordered by function, then data size, then direction.
+     */
+    constexpr HandlerId getEGHandler(bool memoryOperand, AluFunction function, DataSize size, RegDirection direction) {
+        unsigned int first = memoryOperand ? EG_MEMORY_HANDLERS : EG_REGISTER_HANDLERS;
+        return static_cast<HandlerId>(first + function * 4 + size * 2 + direction);
+    }
+
+    /**
+     * Returns whether the given handler executes an E, G instruction with register operands.
+     */
+    constexpr bool isEGRegisterHandler(HandlerId handler) {
+        return handler >= EG_REGISTER_HANDLERS && handler < EG_MEMORY_HANDLERS;
+    }
+
+    /**
+     * Returns whether the given handler executes an E, G instruction (with either a register or memory operand).
+     */
+    constexpr bool isEGHandler(HandlerId handler) {
+        return handler >= EG_REGISTER_HANDLERS && handler < FUSED_PAIR_HANDLERS;
+    }
+
+    /**
+     * Returns the pair formed by instructions with the given handlers or FUSED_PAIR_COUNT should they not form one.
+     */
+    constexpr FusedPair getFusedPair(HandlerId first, HandlerId second) {
+        if(first == PUSH_REGISTER_HANDLER && second == PUSH_REGISTER_HANDLER) return PUSH_PUSH_PAIR;
+        if(first == POP_REGISTER_HANDLER && second == POP_REGISTER_HANDLER) return POP_POP_PAIR;
+        if(first == PUSH_REGISTER_HANDLER && second == POP_REGISTER_HANDLER) return PUSH_POP_PAIR;
+
+        return FUSED_PAIR_COUNT;
+    }
+
+    /**
+     * Returns the identifier of the handler executing both instructions of the given pair.
+     */
+    constexpr HandlerId getFusedPairHandler(FusedPair pair) {
+        return static_cast<HandlerId>(FUSED_PAIR_HANDLERS + pair);
+    }
+
+    /**
+     * Compact, fixed-size representation of a decoded instruction. Unlike the Instruction class hierarchy, this is a
+     * trivially copyable value type that requires no heap allocation and is executed via a handler table rather than
+     * virtual dispatch. As such, it is what the CPU stores in its caches and executes on the hot path.
+     *
+     * Disassembly and raw data access are provided as cold-path views which construct the equivalent Instruction
+     * object on demand.
+     */
+    struct DecodedInstruction {
+        u8 opcode = 0;
+        u8 modRegRm = 0; /// Only meaningful when hasModRegRm is true.
+        bool hasModRegRm = false;
+
+        u8 displacementSize = 0; /// Number of displacement bytes encoded (0, 1 or 2).
+        u8 immediateSize = 0; /// Number of immediate bytes encoded (0, 1 or 2).
+        u8 length = 0; /// Total length of the instruction in bytes.
+
+        HandlerId handler = INVALID_HANDLER;
+
+        /// Handler executing both this and the following instruction of a block (INVALID_HANDLER if not fused).
+        HandlerId pairHandler = INVALID_HANDLER;
+
+        u16 displacement = 0; /// Byte displacements are sign-extended upon decoding.
+        u16 immediate = 0;
+
+        /**
+         * Construct the Instruction object equivalent to this decoded instruction. Involves heap allocation so should
+         * be avoided on the hot path.
+         *
+         * @return The instruction object or an empty pointer should the handler be invalid.
+         */
+        std::unique_ptr<Instruction> toInstruction() const;
+
+        /**
+         * Disassemble this instruction (see Instruction::toAssembly).
+         */
+        std::string toAssembly(const Intel8086& cpu, const assembly::Style& style) const;
+
+        /**
+         * Fetch the raw 8-bit values that make up this instruction (see Instruction::getRawData).
+         */
+        std::vector<u8> getRawData() const;
+
+        /**
+         * Fetch the raw 8-bit values that make up this instruction expressed as a string.
+         *
+         * @param separator The separating string placed between each binary value in the string representation.
+         */
+        std::string getRawDataString(std::string separator = ", ") const;
+    };
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <utility>
+#include "emu/types.hpp"
+#include "emu/cpu/instr/modregrm.hpp"
+#include "emu/cpu/reg/registers8086.hpp"
+
+namespace emu::cpu::instr {
+    /**
+     * Function calculating the offset of a memory operand from the CPU registers and the (sign-extended) displacement
+     * of an instruction.
+     */
+    using EffectiveAddressKernel = OffsetAddr (*)(const reg::GeneralRegisters& registers, u16 displacement);
+
+    /**
+     * How the memory operand of a particular combination of MOD and R/M components is addressed.
+     */
+    struct EffectiveAddressMode {
+        EffectiveAddressKernel kernel;
+        reg::SegmentRegister defaultSegment; /// Segment the offset is within when not overridden.
+    };
+
+    /**
+     * Effective address calculation for each of the memory addressing modes. Used only to generate the
+     * EFFECTIVE_ADDRESS_MODES table.
+     */
+    namespace effectiveaddress {
+        /**
+         * Returns whether the given MOD and R/M combination specifies a direct address (a word displacement alone)
+         * rather than the BP register with no displacement.
+         */
+        constexpr bool isDirectAddress(AddressingMode mode, DisplacementType type) {
+            return mode == NO_DISPLACEMENT && type == BP_DISPLACEMENT;
+        }
+
+        /**
+         * Returns the segment in which the memory operand resides by default: the stack segment for addressing modes
+         * based on BP and the data segment otherwise.
+         */
+        constexpr reg::SegmentRegister getDefaultSegment(AddressingMode mode, DisplacementType type) {
+            switch(type) {
+            case BP_SI_DISPLACEMENT:
+            case BP_DI_DISPLACEMENT:
+                return reg::STACK_SEGMENT;
+
+            case BP_DISPLACEMENT:
+                return isDirectAddress(mode, type) ? reg::DATA_SEGMENT : reg::STACK_SEGMENT;
+
+            default: return reg::DATA_SEGMENT;
+            }
+        }
+
+        template <AddressingMode Mode, DisplacementType Type>
+        OffsetAddr calculate(const reg::GeneralRegisters& registers, u16 displacement) {
+            if constexpr(isDirectAddress(Mode, Type)) return displacement;
+            else {
+                u16 offset = Mode == NO_DISPLACEMENT ? 0 : displacement;
+
+                if constexpr(Type == BX_SI_DISPLACEMENT || Type == BX_DI_DISPLACEMENT || Type == BX_DISPLACEMENT)
+                    offset = static_cast<u16>(offset + registers.get(reg::BX_REGISTER));
+
+                if constexpr(Type == BP_SI_DISPLACEMENT || Type == BP_DI_DISPLACEMENT || Type == BP_DISPLACEMENT)
+                    offset = static_cast<u16>(offset + registers.get(reg::BASE_POINTER));
+
+                if constexpr(Type == BX_SI_DISPLACEMENT || Type == BP_SI_DISPLACEMENT || Type == SI_DISPLACEMENT)
+                    offset = static_cast<u16>(offset + registers.get(reg::SOURCE_INDEX));
+
+                if constexpr(Type == BX_DI_DISPLACEMENT || Type == BP_DI_DISPLACEMENT || Type == DI_DISPLACEMENT)
+                    offset = static_cast<u16>(offset + registers.get(reg::DESTINATION_INDEX));
+
+                return offset;
+            }
+        }
+
+        template <std::size_t Index>
+        constexpr EffectiveAddressMode createMode() {
+            constexpr AddressingMode mode = static_cast<AddressingMode>(Index / 8);
+            constexpr DisplacementType type = static_cast<DisplacementType>(Index % 8);
+
+            return { calculate<mode, type>, getDefaultSegment(mode, type) };
+        }
+
+        template <std::size_t... Indices>
+        constexpr std::array<EffectiveAddressMode, sizeof...(Indices)> createModes(std::index_sequence<Indices...>) {
+            return {{ createMode<Indices>()... }};
+        }
+    }
+
+    /// Number of memory addressing modes (every combination of the MOD components 00, 01 and 10 with an R/M component).
+    constexpr unsigned int EFFECTIVE_ADDRESS_MODE_COUNT = 24;
+
+    /// Table indexed by the MOD component multiplied by 8 plus the R/M component.
+    inline constexpr std::array<EffectiveAddressMode, EFFECTIVE_ADDRESS_MODE_COUNT> EFFECTIVE_ADDRESS_MODES =
+        effectiveaddress::createModes(std::make_index_sequence<EFFECTIVE_ADDRESS_MODE_COUNT>());
+
+    /**
+     * Returns the addressing of the memory operand specified by a MOD-REG-R/M byte (must not use register addressing
+     * mode).
+     */
+    constexpr const EffectiveAddressMode& getEffectiveAddressMode(u8 modRegRm) {
+        return EFFECTIVE_ADDRESS_MODES[(modRegRm >> 6) * 8 + (modRegRm & 0b111)];
+    }
+}
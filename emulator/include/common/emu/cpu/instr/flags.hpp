@@ -0,0 +1,26 @@
+#pragma once
+
+#include "emu/cpu/instr/instruction.hpp"
+
+namespace emu::cpu::instr {
+    /**
+     * Loads the low byte of the FLAGS register (SF, ZF, AF, PF and CF) into the AH register (assembly 'lahf'
+     * identifier).
+     */
+    class LoadAhFromFlags : public Instruction {
+    public:
+        LoadAhFromFlags(Opcode instrOpcode);
+
+        OffsetAddr execute(Intel8086& cpu, Mem& memory) override final;
+    };
+
+    /**
+     * Stores the AH register into the low byte of the FLAGS register (assembly 'sahf' identifier).
+     */
+    class StoreAhIntoFlags : public Instruction {
+    public:
+        StoreAhIntoFlags(Opcode instrOpcode);
+
+        OffsetAddr execute(Intel8086& cpu, Mem& memory) override final;
+    };
+}
\ No newline at end of file
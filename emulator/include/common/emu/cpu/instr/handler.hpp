@@ -0,0 +1,242 @@
+#pragma once
+
+#include <type_traits>
+#include "convert.hpp"
+#include "logging.hpp"
+#include "emu/types.hpp"
+#include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/instr/decodedinstruction.hpp"
+#include "emu/cpu/instr/modregrm.hpp"
+#include "emu/cpu/instr/effectiveaddress.hpp"
+
+namespace emu::cpu::instr {
+    /**
+     * Function executing a decoded instruction. Like Instruction::execute, returns the new instruction pointer value.
+     */
+    using Handler = OffsetAddr (*)(Intel8086& cpu, Mem& memory, const DecodedInstruction& instruction);
+
+    /**
+     * Fetch the function responsible for executing instructions with the given handler identifier.
+     *
+     * @param id The handler identifier (must be less than HANDLER_COUNT).
+     * @return Pointer to the handler function.
+     */
+    Handler getHandler(HandlerId id);
+
+    /**
+     * Returns the general-purpose register encoded by the three least significant bits of opcodes such as PUSH/POP
+     * register (0x50 to 0x5F) and by 16-bit REG/R/M components.
+     */
+    inline reg::GeneralRegister getEncodedWordRegister(u8 bits) {
+        constexpr reg::GeneralRegister registers[8] = {
+            reg::AX_REGISTER, reg::CX_REGISTER, reg::DX_REGISTER, reg::BX_REGISTER,
+            reg::STACK_POINTER, reg::BASE_POINTER, reg::SOURCE_INDEX, reg::DESTINATION_INDEX
+        };
+
+        return registers[bits & 0b111];
+    }
+
+    /**
+     * Implementations of each handler. These are defined inline so that they may be inlined directly into the
+     * dispatch sites of the threaded interpreter as well as being called through the handler table.
+     */
+    namespace handlers {
+        inline OffsetAddr nextAddress(const Intel8086& cpu, const DecodedInstruction& instruction) {
+            return cpu.getRelativeInstructionPointer() + instruction.length;
+        }
+
+        inline OffsetAddr invalid(Intel8086& cpu, Mem&, const DecodedInstruction& instruction) {
+            logging::error("Attempted to execute invalid decoded instruction.");
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr pushRegister(Intel8086& cpu, Mem& memory, const DecodedInstruction& instruction) {
+            u16 value = cpu.generalRegisters.get(getEncodedWordRegister(instruction.opcode));
+            cpu.pushWordToStack(value, memory);
+
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr popRegister(Intel8086& cpu, Mem& memory, const DecodedInstruction& instruction) {
+            u16 value = cpu.popWordFromStack(memory);
+            cpu.generalRegisters.set(getEncodedWordRegister(instruction.opcode), value);
+
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr halt(Intel8086& cpu, Mem&, const DecodedInstruction& instruction) {
+            cpu.halted = true;
+
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr pushFlags(Intel8086& cpu, Mem& memory, const DecodedInstruction& instruction) {
+            cpu.pushWordToStack(cpu.getFlagsWord(), memory);
+
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr popFlags(Intel8086& cpu, Mem& memory, const DecodedInstruction& instruction) {
+            cpu.setFlagsWord(cpu.popWordFromStack(memory));
+
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr loadAhFromFlags(Intel8086& cpu, Mem&, const DecodedInstruction& instruction) {
+            cpu.generalRegisters.setHigh(reg::AX_REGISTER, convert::getLeastSigByte(cpu.getFlagsWord()));
+
+            return nextAddress(cpu, instruction);
+        }
+
+        inline OffsetAddr storeAhIntoFlags(Intel8086& cpu, Mem&, const DecodedInstruction& instruction) {
+            u8 high = convert::getMostSigByte(cpu.getFlagsWord());
+            cpu.setFlagsWord(convert::createWordFromBytes(cpu.generalRegisters.getHigh(reg::AX_REGISTER), high));
+
+            return nextAddress(cpu, instruction);
+        }
+
+        /**
+         * Perform an ALU function on operands of its natural width, recording its effect on the flags.
+         *
+         * @tparam Function The ALU function to perform.
+         * @tparam T The operand type (u8 or u16).
+         * @return The result of the operation (which CMP does not write to its destination).
+         */
+        template <AluFunction Function, typename T>
+        inline T aluOperation(Intel8086& cpu, T destination, T source) {
+            static_assert(std::is_same_v<T, u8> || std::is_same_v<T, u16>, "ALU operands must be bytes or words.");
+
+            T result = 0;
+
+            if constexpr(Function == ADD_FUNCTION) result = destination + source;
+            else if constexpr(Function == OR_FUNCTION) result = destination | source;
+            else if constexpr(Function == ADC_FUNCTION) result = destination + source + cpu.getFlag(reg::CARRY_FLAG);
+            else if constexpr(Function == SBB_FUNCTION) result = destination - source - cpu.getFlag(reg::CARRY_FLAG);
+            else if constexpr(Function == AND_FUNCTION) result = destination & source;
+            else if constexpr(Function == XOR_FUNCTION) result = destination ^ source;
+            else result = destination - source; // SUB and CMP.
+
+            cpu.recordAluOperation(getFlagOperation(Function), std::is_same_v<T, u16>, destination, source, result);
+            return result;
+        }
+
+        /**
+         * E, G instruction (ADD, OR, ADC, SBB, AND, SUB, XOR or CMP) with register addressing mode. Every combination
+         * of function, data size and direction is a separate straight-line handler.
+         */
+        template <AluFunction Function, DataSize Size, RegDirection Direction>
+        OffsetAddr egRegister(Intel8086& cpu, Mem&, const DecodedInstruction& instruction) {
+            using T = std::conditional_t<Size == WORD_DATA_SIZE, u16, u8>;
+
+            const ModRegRmInfo& info = ModRegRm(instruction.modRegRm).getInfo(Size);
+
+            T regValue = static_cast<T>(cpu.generalRegisters.get(info.regIndex, info.regPart));
+            T rmValue = static_cast<T>(cpu.generalRegisters.get(info.rmIndex, info.rmPart));
+
+            if constexpr(Direction == REG_IS_SOURCE) {
+                T result = aluOperation<Function>(cpu, rmValue, regValue);
+                if constexpr(writesResult(Function)) cpu.generalRegisters.set(info.rmIndex, info.rmPart, result);
+            }
+            else {
+                T result = aluOperation<Function>(cpu, regValue, rmValue);
+                if constexpr(writesResult(Function)) cpu.generalRegisters.set(info.regIndex, info.regPart, result);
+            }
+
+            return nextAddress(cpu, instruction);
+        }
+
+        /**
+         * Read a byte or word memory operand. The most significant byte of a word is read from the following offset
+         * within the same segment (see Intel8086::readWord).
+         */
+        template <typename T>
+        inline T readOperand(const Intel8086& cpu, const Mem& memory, reg::SegmentRegister segment, OffsetAddr offset) {
+            if constexpr(std::is_same_v<T, u8>) return memory.read(cpu.resolveAddress(offset, segment));
+            else return cpu.readWord(offset, segment, memory);
+        }
+
+        /**
+         * Write a byte or word memory operand (see readOperand).
+         */
+        template <typename T>
+        inline void writeOperand(const Intel8086& cpu, Mem& memory, reg::SegmentRegister segment, OffsetAddr offset,
+                                 T value) {
+            if constexpr(std::is_same_v<T, u8>) memory.write(cpu.resolveAddress(offset, segment), value);
+            else cpu.writeWord(offset, segment, value, memory);
+        }
+
+        /**
+         * E, G instruction with a memory operand. The offset of the operand is calculated by the effective address
+         * kernel of the MOD and R/M components and is within the default segment of that addressing mode.
+         */
+        template <AluFunction Function, DataSize Size, RegDirection Direction>
+        OffsetAddr egMemory(Intel8086& cpu, Mem& memory, const DecodedInstruction& instruction) {
+            using T = std::conditional_t<Size == WORD_DATA_SIZE, u16, u8>;
+
+            const ModRegRmInfo& info = ModRegRm(instruction.modRegRm).getInfo(Size);
+            const EffectiveAddressMode& mode = getEffectiveAddressMode(instruction.modRegRm);
+
+            OffsetAddr offset = mode.kernel(cpu.generalRegisters, instruction.displacement);
+
+            T regValue = static_cast<T>(cpu.generalRegisters.get(info.regIndex, info.regPart));
+            T memoryValue = readOperand<T>(cpu, memory, mode.defaultSegment, offset);
+
+            if constexpr(Direction == REG_IS_SOURCE) {
+                T result = aluOperation<Function>(cpu, memoryValue, regValue);
+                if constexpr(writesResult(Function)) writeOperand(cpu, memory, mode.defaultSegment, offset, result);
+            }
+            else {
+                T result = aluOperation<Function>(cpu, regValue, memoryValue);
+                if constexpr(writesResult(Function)) cpu.generalRegisters.set(info.regIndex, info.regPart, result);
+            }
+
+            return nextAddress(cpu, instruction);
+        }
+
+        /**
+         * Execute an instruction and the instruction following it in its block as a single handler (see FusedPair).
+         * The instruction pointer is updated between the two such that the architectural state is exactly as if they
+         * had been executed separately. Should the first instruction write to the memory that the second was decoded
+         * from, or should the instruction pointer following the first not be valid, the second is not executed and the
+         * instruction pointer following the first is returned (to be completed as that of a single instruction).
+         *
+         * @tparam FirstWritesMemory Whether the first handler may write to memory.
+         */
+        template <Handler First, Handler Second, bool FirstWritesMemory>
+        OffsetAddr fusedPair(Intel8086& cpu, Mem& memory, const DecodedInstruction& first) {
+            const DecodedInstruction& second = (&first)[1]; // Pairs are only formed from consecutive block instructions.
+
+            AbsAddr secondAddress = cpu.resolveAddress(nextAddress(cpu, first), reg::CODE_SEGMENT);
+            u32 generation = FirstWritesMemory ? memory.getGeneration(secondAddress, secondAddress + second.length - 1)
+                                               : 0;
+
+            OffsetAddr middle = First(cpu, memory, first);
+
+            if(FirstWritesMemory &&
+               memory.getGeneration(secondAddress, secondAddress + second.length - 1) != generation) return middle;
+
+            if(!cpu.completeExecution(middle, memory)) return middle;
+            return Second(cpu, memory, second);
+        }
+    }
+}
+
+/**
+ * Expands X(function, size, direction) for every E, G handler variant in HandlerId order. Used to generate the handler
+ * table and the labels of the threaded interpreter.
+ */
+#define WIRED86_EG_VARIANTS_OF(X, function) \
+    X(function, WORD_DATA_SIZE, REG_IS_SOURCE) \
+    X(function, WORD_DATA_SIZE, REG_IS_DESTINATION) \
+    X(function, BYTE_DATA_SIZE, REG_IS_SOURCE) \
+    X(function, BYTE_DATA_SIZE, REG_IS_DESTINATION)
+
+#define WIRED86_FOR_EACH_EG_VARIANT(X) \
+    WIRED86_EG_VARIANTS_OF(X, ADD_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, OR_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, ADC_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, SBB_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, AND_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, SUB_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, XOR_FUNCTION) \
+    WIRED86_EG_VARIANTS_OF(X, CMP_FUNCTION)
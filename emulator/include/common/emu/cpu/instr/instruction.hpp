@@ -17,10 +17,12 @@ namespace emu::cpu::instr {
         /**
          * Create a new instruction representation object.
          *
-         * @param instrIdentifier Assembly code identifier for this instruction (e.g. "mov").
+         * @param instrIdentifier Assembly code identifier for this instruction (e.g. "mov"). Must be a string with
+         *        static storage duration (such as a string literal) as it is not copied.
          * @param instrOpcode The Opcode object of this instruction.
+         * @param instrRawSize The number of bytes that make up this instruction (defaults to just the opcode).
          */
-        Instruction(std::string instrIdentifier, Opcode instrOpcode);
+        Instruction(const char* instrIdentifier, Opcode instrOpcode, OffsetAddr instrRawSize = 1);
 
         /**
          * Execute this instruction using the given CPU internal values.
@@ -65,7 +67,8 @@ namespace emu::cpu::instr {
         std::string getRawDataString(std::string separator = ", ") const;
 
         /**
-         * Returns the number of bytes that make up this instruction.
+         * Returns the number of bytes that make up this instruction as given on construction such that the size is
+         * known without constructing the raw data.
          */
         OffsetAddr getRawSize() const;
 
@@ -76,8 +79,11 @@ namespace emu::cpu::instr {
          */
         OffsetAddr nextAddress(const Intel8086& cpu) const;
 
-        const std::string identifier;
+        const char* const identifier;
         const Opcode opcode;
+
+    private:
+        const OffsetAddr rawSize;
     };
 
     /**
@@ -94,7 +100,7 @@ namespace emu::cpu::instr {
          * @param generalReg The register index that this instruction takes as an argument.
          * @param part The register part used by this instruction (defaults to using the full 16-bit register).
          */
-        InstructionTakingRegister(std::string instrIdentifier, Opcode instrOpcode, reg::GeneralRegister generalReg,
+        InstructionTakingRegister(const char* instrIdentifier, Opcode instrOpcode, reg::GeneralRegister generalReg,
                                   reg::RegisterPart part = reg::FULL_WORD);
 
         /**
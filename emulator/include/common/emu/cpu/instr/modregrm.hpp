@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <string>
 #include "primitives.hpp"
 #include "emu/cpu/instr/opcode.hpp"
 #include "emu/cpu/reg/registers8086.hpp"
@@ -23,43 +25,213 @@ namespace emu::cpu::instr {
         BX_DISPLACEMENT
     };
 
+    /**
+     * Decoding of the individual components of a MOD-REG-R/M byte. These are only used to generate the
+     * MODREGRM_TABLES at compile time and so are never executed at run time.
+     */
+    namespace modregrm {
+        /**
+         * Return the appropriate AddressingMode enumeration value based on the MOD component bits.
+         */
+        constexpr AddressingMode decodeAddressingMode(u8 bits) {
+            switch(bits) {
+            case 0b00: return NO_DISPLACEMENT;
+            case 0b01: return BYTE_DISPLACEMENT;
+            case 0b10: return WORD_DISPLACEMENT;
+            case 0b11: return REGISTER_ADDRESSING_MODE;
+            }
+
+            return NO_DISPLACEMENT;
+        }
+
+        /**
+         * Returns the appropriate displacement type based on the R/M component bits.
+         */
+        constexpr DisplacementType decodeDisplacementType(u8 bits) {
+            switch(bits) {
+            case 0b000: return BX_SI_DISPLACEMENT;
+            case 0b001: return BX_DI_DISPLACEMENT;
+            case 0b010: return BP_SI_DISPLACEMENT;
+            case 0b011: return BP_DI_DISPLACEMENT;
+            case 0b100: return SI_DISPLACEMENT;
+            case 0b101: return DI_DISPLACEMENT;
+            case 0b110: return BP_DISPLACEMENT;
+            case 0b111: return BX_DISPLACEMENT;
+            }
+
+            return BX_SI_DISPLACEMENT;
+        }
+
+        /**
+         * Returns the number of displacement bytes following the MOD-REG-R/M byte for the given addressing mode and
+         * displacement type.
+         */
+        constexpr u8 decodeDisplacementReadLength(AddressingMode mode, DisplacementType type) {
+            switch(mode) {
+            case BYTE_DISPLACEMENT: return 1; // Read 1 byte.
+            case WORD_DISPLACEMENT: return 2; // Read word (i.e. 2 bytes).
+
+            // With no displacement, BP is instead replaced by a direct address given as a word displacement:
+            case NO_DISPLACEMENT: return type == BP_DISPLACEMENT ? 2 : 0;
+
+            default: return 0; // Niether byte nor word displacement is actually being used.
+            }
+        }
+
+        /**
+         * Returns the appropriate register index based on 3 bits given and the data size.
+         *
+         * @param The 3 bits of either a REG or R/M component that specify a register.
+         * @param size The data size handled by this instruction (16-bit word or 8-bit byte).
+         * @return A general register index.
+         */
+        constexpr reg::GeneralRegister decodeRegisterIndex(u8 bits, DataSize size) {
+            if(size == BYTE_DATA_SIZE) {
+                switch(bits) {
+                case 0b000: // AL
+                case 0b100: // AH
+                    return reg::AX_REGISTER;
+
+                case 0b001: // CL
+                case 0b101: // CH
+                    return reg::CX_REGISTER;
+
+                case 0b010: // DL
+                case 0b110: // DH
+                    return reg::DX_REGISTER;
+
+                case 0b011: // BL
+                case 0b111: // BH
+                    return reg::BX_REGISTER;
+                }
+            }
+
+            if(size == WORD_DATA_SIZE) {
+                switch(bits) {
+                case 0b000: return reg::AX_REGISTER;
+                case 0b001: return reg::CX_REGISTER;
+                case 0b010: return reg::DX_REGISTER;
+                case 0b011: return reg::BX_REGISTER;
+                case 0b100: return reg::STACK_POINTER;
+                case 0b101: return reg::BASE_POINTER;
+                case 0b110: return reg::SOURCE_INDEX;
+                case 0b111: return reg::DESTINATION_INDEX;
+                }
+            }
+
+            return reg::AX_REGISTER;
+        }
+
+        /**
+         * Returns the appropriate register part (low byte, high byte, or full word) based on the 3 bits given and the
+         * the data size. Will always return full word when given a 16-bit data size option.
+         *
+         * @param The 3 bits of either a REG or R/M component that specify a register.
+         * @param size The data size handled by this instruction (16-bit word or 8-bit byte).
+         * @return A register part.
+         */
+        constexpr reg::RegisterPart decodeRegisterPart(u8 bits, DataSize size) {
+            if(size == BYTE_DATA_SIZE) {
+                switch(bits) {
+                case 0b000: // AL
+                case 0b001: // CL
+                case 0b010: // DL
+                case 0b011: // BL
+                    return reg::LOW_BYTE;
+
+                case 0b100: // AH
+                case 0b101: // CH
+                case 0b110: // DH
+                case 0b111: // BH
+                    return reg::HIGH_BYTE;
+                }
+            }
+
+            return reg::FULL_WORD;
+        }
+    }
+
+    /**
+     * Every property of a MOD-REG-R/M byte value for a particular data size.
+     */
+    struct ModRegRmInfo {
+        AddressingMode addressingMode = NO_DISPLACEMENT;
+        u8 displacementReadLength = 0;
+        DisplacementType displacementType = BX_SI_DISPLACEMENT;
+        reg::GeneralRegister regIndex = reg::AX_REGISTER, rmIndex = reg::AX_REGISTER;
+        reg::RegisterPart regPart = reg::FULL_WORD, rmPart = reg::FULL_WORD;
+    };
+
+    /**
+     * Builds the table describing every MOD-REG-R/M byte value for the given data size at compile time.
+     */
+    constexpr std::array<ModRegRmInfo, 256> createModRegRmTable(DataSize size) {
+        std::array<ModRegRmInfo, 256> table = {};
+
+        for(unsigned int value = 0; value < 256; value++) {
+            u8 mod = static_cast<u8>(value >> 6), reg = (value >> 3) & 0b111, rm = value & 0b111;
+            ModRegRmInfo& info = table[value];
+
+            info.addressingMode = modregrm::decodeAddressingMode(mod);
+            info.displacementType = modregrm::decodeDisplacementType(rm);
+            info.displacementReadLength = modregrm::decodeDisplacementReadLength(info.addressingMode,
+                                                                                  info.displacementType);
+            info.regIndex = modregrm::decodeRegisterIndex(reg, size);
+            info.regPart = modregrm::decodeRegisterPart(reg, size);
+            info.rmIndex = modregrm::decodeRegisterIndex(rm, size);
+            info.rmPart = modregrm::decodeRegisterPart(rm, size);
+        }
+
+        return table;
+    }
+
+    /// Tables indexed by DataSize and then MOD-REG-R/M byte value.
+    inline constexpr std::array<std::array<ModRegRmInfo, 256>, 2> MODREGRM_TABLES = {
+        createModRegRmTable(WORD_DATA_SIZE), createModRegRmTable(BYTE_DATA_SIZE)
+    };
+
+    /**
+     * A MOD-REG-R/M byte. All of the getters are simple lookups into the MODREGRM_TABLES.
+     */
     class ModRegRm {
     public:
-        ModRegRm(u8 modRegRmValue);
+        constexpr ModRegRm(u8 modRegRmValue) : value(modRegRmValue) {}
 
         /**
          * Fetch the three bits that comprise the R/M component of this MOD-REG-R/M byte.
          */
-        u8 getRmBits() const;
+        constexpr u8 getRmBits() const { return value & 0b111; }
         
         /**
          * Fetch the three bits that make up the REG component of this MOD-REG-R/M byte.
          */
-        u8 getRegBits() const;
+        constexpr u8 getRegBits() const { return (value >> 3) & 0b111; }
 
         /**
          * Fetch the pair of bits that comprise the MOD component of this MOD-REG-R/M byte.
          */
-        u8 getModBits() const;
+        constexpr u8 getModBits() const { return static_cast<u8>(value >> 6); }
 
         /**
          * Return the appropriate AddressingMode enumeration value based on the MOD component bits.
          */
-        AddressingMode getAddressingMode() const;
+        constexpr AddressingMode getAddressingMode() const { return getInfo(WORD_DATA_SIZE).addressingMode; }
 
-        AbsAddr getDisplacementReadLength() const;
+        constexpr AbsAddr getDisplacementReadLength() const {
+            return getInfo(WORD_DATA_SIZE).displacementReadLength;
+        }
 
         /**
          * Get the appropriate register index based on the value of the R/M component.
          * Only relevant when using register addressing mode.
          */
-        reg::GeneralRegister getRegisterIndexFromRm(DataSize size) const;
+        constexpr reg::GeneralRegister getRegisterIndexFromRm(DataSize size) const { return getInfo(size).rmIndex; }
 
         /**
          * Returns the appropriate register part based on the value of the R/M component.
          * Only relevant when using register addressing mode.
          */
-        reg::RegisterPart getRegisterPartFromRm(DataSize size) const;
+        constexpr reg::RegisterPart getRegisterPartFromRm(DataSize size) const { return getInfo(size).rmPart; }
 
         /**
          *
@@ -69,12 +241,12 @@ namespace emu::cpu::instr {
         /**
          * Get the appropriate register index based on the value of the REG component.
          */
-        reg::GeneralRegister getRegisterIndexFromReg(DataSize size) const;
+        constexpr reg::GeneralRegister getRegisterIndexFromReg(DataSize size) const { return getInfo(size).regIndex; }
 
         /**
          * Returns the appropriate register part based on the value of the REG component.
          */
-        reg::RegisterPart getRegisterPartFromReg(DataSize size) const;
+        constexpr reg::RegisterPart getRegisterPartFromReg(DataSize size) const { return getInfo(size).regPart; }
 
         /**
          *
@@ -84,34 +256,19 @@ namespace emu::cpu::instr {
         /**
          * Returns the appropriate displacement type based on the value of the R/M component.
          */
-        DisplacementType getDisplacementType() const;
+        constexpr DisplacementType getDisplacementType() const { return getInfo(WORD_DATA_SIZE).displacementType; }
 
         /**
-         * Returns true when R/M indicates that either byte displacement or word displacement is to be used. Otherwise,
-         * returns false.
+         * Returns true when MOD and R/M indicate that either a byte or word displacement (including a direct address)
+         * follows the MOD-REG-R/M byte. Otherwise, returns false.
          */
-        bool isDisplacementUsed() const;
+        constexpr bool isDisplacementUsed() const { return getDisplacementReadLength() != 0; }
 
-        const u8 value;
-
-    private:
         /**
-         * Returns the appropriate register index based on 3 bits given and the data size.
-         *
-         * @param The 3 bits of either a REG or R/M component that specify a register.
-         * @param size The data size handled by this instruction (16-bit word or 8-bit byte).
-         * @return A general register index.
+         * Returns the table entry describing this MOD-REG-R/M byte for the given data size.
          */
-        reg::GeneralRegister getRegisterIndex(u8 bits, DataSize size) const;
+        constexpr const ModRegRmInfo& getInfo(DataSize size) const { return MODREGRM_TABLES[size][value]; }
 
-        /**
-         * Returns the appropriate register part (low byte, high byte, or full word) based on the 3 bits given and the
-         * the data size. Will always return full word when given a 16-bit data size option.
-         *
-         * @param The 3 bits of either a REG or R/M component that specify a register.
-         * @param size The data size handled by this instruction (16-bit word or 8-bit byte).
-         * @return A register part.
-         */
-        reg::RegisterPart getRegisterPart(u8 bits, DataSize size) const;
+        const u8 value;
     };
 }
\ No newline at end of file
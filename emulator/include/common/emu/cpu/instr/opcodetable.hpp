@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include "primitives.hpp"
+#include "emu/cpu/instr/decodedinstruction.hpp"
+
+namespace emu::cpu::instr {
+    /**
+     * Describes how an instruction with a particular opcode byte is encoded and executed.
+     */
+    struct OpcodeInfo {
+        HandlerId handler = INVALID_HANDLER; /// Handler executing the instruction (INVALID_HANDLER if unimplemented).
+        bool hasModRegRm = false; /// Whether a MOD-REG-R/M byte immediately follows the opcode.
+        u8 immediateSize = 0; /// Number of immediate bytes following the opcode/MOD-REG-R/M/displacement.
+        bool endsBlock = false; /// Whether the instruction may transfer control or halt (ending a basic block).
+        HandlerId memoryHandler = INVALID_HANDLER; /// Handler used instead when MOD-REG-R/M specifies a memory operand.
+    };
+
+    /**
+     * Builds the opcode table at compile time. Implementing a new instruction is simply a matter of filling in the
+     * entries for its opcodes here.
+     */
+    constexpr std::array<OpcodeInfo, 256> createOpcodeTable() {
+        std::array<OpcodeInfo, 256> table = {};
+
+        for(unsigned int opcode = 0x00; opcode < 0x40; opcode++) { // ADD, OR, ADC, SBB, AND, SUB, XOR, CMP E, G
+            if((opcode & 0b111) > 0b011) continue; // Not an E, G opcode (immediate, segment and prefix opcodes).
+
+            AluFunction function = getEncodedAluFunction(static_cast<u8>(opcode));
+            DataSize size = opcode & 0b01 ? WORD_DATA_SIZE : BYTE_DATA_SIZE;
+            RegDirection direction = opcode & 0b10 ? REG_IS_DESTINATION : REG_IS_SOURCE;
+
+            table[opcode] = { getEGHandler(false, function, size, direction), true, 0, false,
+                              getEGHandler(true, function, size, direction) };
+        }
+
+        for(unsigned int opcode = 0x50; opcode <= 0x57; opcode++) // PUSH AX, CX, DX, BX, SP, BP, SI, DI
+            table[opcode] = { PUSH_REGISTER_HANDLER, false, 0 };
+
+        for(unsigned int opcode = 0x58; opcode <= 0x5F; opcode++) // POP AX, CX, DX, BX, SP, BP, SI, DI
+            table[opcode] = { POP_REGISTER_HANDLER, false, 0 };
+
+        table[0x9C] = { PUSH_FLAGS_HANDLER, false, 0 }; // PUSHF
+        table[0x9D] = { POP_FLAGS_HANDLER, false, 0 }; // POPF
+        table[0x9E] = { STORE_AH_INTO_FLAGS_HANDLER, false, 0 }; // SAHF
+        table[0x9F] = { LOAD_AH_FROM_FLAGS_HANDLER, false, 0 }; // LAHF
+
+        table[0xF4] = { HALT_HANDLER, false, 0, true }; // HLT
+
+        return table;
+    }
+
+    /// Table indexed by opcode byte describing every possible instruction opcode.
+    inline constexpr std::array<OpcodeInfo, 256> OPCODE_TABLE = createOpcodeTable();
+}
@@ -22,4 +22,24 @@ namespace emu::cpu::instr {
 
         OffsetAddr execute(Intel8086& cpu, Mem& memory) override final;
     };
+
+    /**
+     * Pushes the FLAGS register onto the stack (assembly 'pushf' identifier).
+     */
+    class PushFlags : public Instruction {
+    public:
+        PushFlags(Opcode instrOpcode);
+
+        OffsetAddr execute(Intel8086& cpu, Mem& memory) override final;
+    };
+
+    /**
+     * Pops the FLAGS register off the stack (assembly 'popf' identifier).
+     */
+    class PopFlags : public Instruction {
+    public:
+        PopFlags(Opcode instrOpcode);
+
+        OffsetAddr execute(Intel8086& cpu, Mem& memory) override final;
+    };
 }
\ No newline at end of file
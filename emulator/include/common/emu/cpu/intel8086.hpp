@@ -1,26 +1,84 @@
 #pragma once
 
+#include <array>
 #include <memory>
+#include <optional>
+#include <unordered_set>
 #include "emu/types.hpp"
 #include "emu/cpu/instr/instruction.hpp"
+#include "emu/cpu/instr/decodedinstruction.hpp"
+#include "emu/cpu/decodecache.hpp"
+#include "emu/cpu/blockcache.hpp"
 #include "emu/cpu/reg/registers8086.hpp"
+#include "emu/cpu/reg/lazyflags.hpp"
+
+namespace emu::cpu::jit {
+    class Translator;
+}
 
 namespace emu::cpu {
+    /**
+     * Outcome of executing a basic block of instructions via Intel8086::executeBlock.
+     */
+    struct BlockResult {
+        unsigned int instructionsExecuted = 0; /// Number of instructions executed successfully.
+        bool success = false; /// False if an instruction could not be decoded or failed to execute.
+    };
+
+    /**
+     * Reason for Intel8086::run returning.
+     */
+    enum StopReason {
+        HALTED_STOP, /// The CPU is halted.
+        BUDGET_STOP, /// The maximum number of instructions has been executed.
+        DECODE_FAILURE_STOP, /// The instruction at CS:IP could not be decoded.
+        EXECUTION_FAILURE_STOP, /// An instruction failed to execute (e.g. produced an invalid instruction pointer).
+        BREAKPOINT_STOP /// CS:IP has reached a breakpoint (the instruction at which has not yet been executed).
+    };
+
+    /**
+     * Outcome of executing instructions via Intel8086::run.
+     */
+    struct RunResult {
+        unsigned long instructionsRetired = 0; /// Number of instructions executed successfully.
+        StopReason reason = BUDGET_STOP;
+    };
+
+    /**
+     * Bytes of memory from which a single instruction is decoded, as read by Intel8086::fetchWindow.
+     */
+    struct FetchWindow {
+        /// No 8086 instruction (ignoring prefixes) is longer than this many bytes.
+        static constexpr unsigned int MAX_INSTRUCTION_LENGTH = 6;
+
+        AbsAddr address = 0; /// Absolute address of the first byte.
+        u8 bytes[MAX_INSTRUCTION_LENGTH] = {}; /// Instruction bytes (only the first available of which are valid).
+        u8 available = 0; /// Number of bytes that could be read before reaching the end of memory.
+        bool wrapped = false; /// Whether the window wraps around from the end to the start of the code segment.
+    };
+
     /**
      * Class representing the main Intel 8086 microprocessor. Handles decoding and execution of instructions fetched
      * from memory. Also holds all CPU registers.
      */
     class Intel8086 {
     public:
+        Intel8086();
+        ~Intel8086();
+
         /**
          * Takes a 16-bit memory offset and a 16-bit segment register and returns an absolute 20-bit address (which is
-         * stored in an unsigned 32-bit integer since there is no 20-bit integer type available in C++).
+         * stored in an unsigned 32-bit integer since there is no 20-bit integer type available in C++). Addresses
+         * beyond 1 MiB wrap around to the start of memory as they do on the 8086. Defined here so that it may be
+         * inlined into every memory access.
          *
          * @param offset The memory offset within the given segment.
          * @param segment Segment register index indicating which segment to resolve the offset within.
          * @return Absolute 20-bit address within memory.
          */
-        AbsAddr resolveAddress(OffsetAddr offset, reg::SegmentRegister segment) const;
+        AbsAddr resolveAddress(OffsetAddr offset, reg::SegmentRegister segment) const {
+            return (segmentRegisters.getBase(segment) + offset) & ABSOLUTE_ADDRESS_MASK;
+        }
 
         /**
          * Returns the relative address of the instruction pointer (i.e. before it is segmented within the code
@@ -37,20 +95,151 @@ namespace emu::cpu {
         AbsAddr getAbsoluteInstructionPointer() const;
 
         /**
-         * Fetches and decodes the next instruction.
+         * Fetches and decodes the next instruction. Instructions previously decoded from the same address are returned
+         * from the decode cache, provided that the memory they were decoded from has not since been written to.
          *
          * @param address The absolute address of the instruction to fetch and decode.
          * @param memory Reference to the memory to fetch the instruction data from.
-         * @return Decoded instruction object (will be empty if instruction decoding fails).
+         * @return Decoded instruction (will be empty if instruction decoding fails).
+         */
+        std::optional<instr::DecodedInstruction> fetchDecodeInstruction(AbsAddr address, const Mem& memory) const;
+
+        /**
+         * Executes a decoded instruction on this CPU via its handler.
+         *
+         * @param instruction Constant reference to the decoded instruction.
+         * @return Whether the instruction was executed successfully.
+         */
+        bool executeInstruction(const instr::DecodedInstruction& instruction, Mem& memory);
+
+        /**
+         * Executes an instruction object on this CPU via its virtual Instruction::execute method. Slower than
+         * executing a decoded instruction but retained as a reference implementation.
+         *
+         * @param instruction Reference to the instruction object.
+         * @return Whether the instruction was executed successfully.
+         */
+        bool executeInstruction(instr::Instruction& instruction, Mem& memory);
+
+        /**
+         * Executes the basic block beginning at the current CS:IP, decoding it first should it not already be held in
+         * the block cache. Execution of the block stops early should the CPU halt, an instruction fail, the block be
+         * modified by one of its own instructions, or the maximum number of instructions be reached.
+         *
+         * Each instruction in the block is executed exactly as it would be by Intel8086::executeInstruction.
+         *
+         * @param memory Reference to the memory to fetch instructions from.
+         * @param maxInstructions The maximum number of instructions to execute.
+         * @return Number of instructions executed and whether all of them executed successfully.
          */
-        std::unique_ptr<instr::Instruction> fetchDecodeInstruction(AbsAddr address, const Mem& memory) const;
+        BlockResult executeBlock(Mem& memory, unsigned int maxInstructions = BasicBlock::MAX_LENGTH);
 
         /**
-         * Executes a decoded instruction on this CPU.
+         * Execute instructions beginning at the current CS:IP until the CPU halts, an instruction cannot be decoded
+         * or executed, a breakpoint is reached, or the budget is exhausted. Instructions are executed a block at a
+         * time without any logging, making this the fastest way for a host to drive the CPU.
+         *
+         * Breakpoints are checked before every instruction except the first, such that calling this method again after
+         * stopping at a breakpoint resumes execution.
          *
-         * @param instruction Reference to the std::unique_ptr holding the instruction.
+         * @param memory Reference to the memory to fetch instructions from.
+         * @param budget The maximum number of instructions to execute.
+         * @return Number of instructions retired and the reason for stopping.
          */
-        bool executeInstruction(std::unique_ptr<instr::Instruction>& instruction, Mem& memory);
+        RunResult run(Mem& memory, unsigned long budget);
+
+        /**
+         * Add a breakpoint at the given absolute address, causing Intel8086::run to stop before the instruction there.
+         */
+        void addBreakpoint(AbsAddr address);
+
+        /**
+         * Remove the breakpoint at the given absolute address (if there is one).
+         */
+        void removeBreakpoint(AbsAddr address);
+
+        /**
+         * Remove all breakpoints.
+         */
+        void clearBreakpoints();
+
+        /**
+         * Returns whether there is a breakpoint at the given absolute address.
+         */
+        bool hasBreakpoint(AbsAddr address) const;
+
+        /**
+         * Returns a constant reference to the cache of decoded instructions (useful for querying hit/miss counts).
+         */
+        const DecodeCache& getDecodeCache() const;
+
+        /**
+         * Returns a constant reference to the cache of decoded basic blocks.
+         */
+        const BlockCache& getBlockCache() const;
+
+        /**
+         * Enable or disable the fusion of a pair of instructions into a single handler when decoding blocks (all
+         * pairs are fused by default). Previously decoded blocks are discarded.
+         */
+        void setPairFusion(instr::FusedPair pair, bool enabled);
+
+        /**
+         * Returns whether the given pair of instructions is fused into a single handler when decoding blocks.
+         */
+        bool isPairFusionEnabled(instr::FusedPair pair) const;
+
+        /**
+         * Returns the number of pairs of instructions that have been executed by a single fused handler.
+         */
+        unsigned long getFusedPairExecutions() const;
+
+        /**
+         * Enable or disable translation of frequently executed blocks into native code by Intel8086::executeBlock.
+         * Translation is only enabled should it be supported on the host platform.
+         *
+         * @return Whether translation is now enabled.
+         */
+        bool setJitEnabled(bool enabled);
+
+        /**
+         * Returns whether frequently executed blocks are translated into native code.
+         */
+        bool isJitEnabled() const;
+
+        /**
+         * Returns a pointer to the translator (useful for querying translation statistics) or nullptr should
+         * translation not be enabled.
+         */
+        const jit::Translator* getTranslator() const;
+
+        /**
+         * Get the value of a CPU flag. Status flags are calculated from the last ALU operation on demand.
+         */
+        bool getFlag(reg::Flag flag) const;
+
+        /**
+         * Explicitly set the value of a CPU flag.
+         */
+        void setFlag(reg::Flag flag, bool value);
+
+        /**
+         * Get the value of the 16-bit FLAGS register (as pushed by PUSHF).
+         */
+        u16 getFlagsWord() const;
+
+        /**
+         * Set every CPU flag at once from a FLAGS register value (as popped by POPF).
+         */
+        void setFlagsWord(u16 value);
+
+        /**
+         * Record an ALU operation that determines the status flags (see reg::LazyFlags::record). Defined here so that
+         * it may be inlined into instruction handlers.
+         */
+        void recordAluOperation(reg::AluOperation operation, bool word, u16 destination, u16 source, u16 result) {
+            flags.record(operation, word, destination, source, result);
+        }
 
         /**
          * Push values onto the stack. Stack pointer decremented.
@@ -63,20 +252,70 @@ namespace emu::cpu {
         MemValue popFromStack(const Mem& memory);
 
         /**
-         * Push a 16-bit word value onto the stack.
+         * Read a little-endian 16-bit word at an offset within a segment. The most significant byte is read from the
+         * following offset, which wraps around to the start of the segment (and of memory at 1 MiB) as on the 8086.
+         * Defined here so that it may be inlined into instruction handlers, as are the other word accesses below.
+         */
+        u16 readWord(OffsetAddr offset, reg::SegmentRegister segment, const Mem& memory) const {
+            AbsAddr address = resolveAddress(offset, segment);
+            if(offset != 0xFFFF && address != ABSOLUTE_ADDRESS_MASK) return memory.readWord(address);
+
+            AbsAddr highAddress = resolveAddress(static_cast<OffsetAddr>(offset + 1), segment);
+            return convert::createWordFromBytes(memory.read(address), memory.read(highAddress));
+        }
+
+        /**
+         * Write a little-endian 16-bit word at an offset within a segment (see readWord).
          */
-        void pushWordToStack(u16 value, Mem& memory);
+        void writeWord(OffsetAddr offset, reg::SegmentRegister segment, u16 value, Mem& memory) const {
+            AbsAddr address = resolveAddress(offset, segment);
+
+            if(offset != 0xFFFF && address != ABSOLUTE_ADDRESS_MASK) memory.writeWord(address, value);
+            else {
+                AbsAddr highAddress = resolveAddress(static_cast<OffsetAddr>(offset + 1), segment);
+
+                memory.write(address, convert::getLeastSigByte(value));
+                memory.write(highAddress, convert::getMostSigByte(value));
+            }
+        }
+
+        /**
+         * Push a 16-bit word value onto the stack with a single stack pointer update. The stack pointer wraps around
+         * within the stack segment. Should the memory access fail, the stack pointer is left unchanged.
+         */
+        void pushWordToStack(u16 value, Mem& memory) {
+            OffsetAddr stackPointer = static_cast<OffsetAddr>(generalRegisters.get(reg::STACK_POINTER) - 2);
+
+            writeWord(stackPointer, reg::STACK_SEGMENT, value, memory);
+            generalRegisters.set(reg::STACK_POINTER, stackPointer);
+        }
 
         /**
-         * Pop 16-bit word value off the stack.
+         * Pop a 16-bit word value off the stack with a single stack pointer update (see pushWordToStack).
          */
-        u16 popWordFromStack(const Mem& memory);
+        u16 popWordFromStack(const Mem& memory) {
+            OffsetAddr stackPointer = generalRegisters.get(reg::STACK_POINTER);
+
+            u16 value = readWord(stackPointer, reg::STACK_SEGMENT, memory);
+            generalRegisters.set(reg::STACK_POINTER, static_cast<OffsetAddr>(stackPointer + 2));
+
+            return value;
+        }
 
         /**
          * Sets the instruction pointer without altering any segment addresses.
          */
         void performRelativeJump(OffsetAddr offset);
 
+        /**
+         * Update the instruction pointer following the execution of an instruction. Public so that handlers executing
+         * several instructions (see instr::handlers::fusedPair) may complete each in turn.
+         *
+         * @param newIp The instruction pointer value returned by the executed instruction.
+         * @return Whether the new instruction pointer value is valid.
+         */
+        bool completeExecution(OffsetAddr newIp, const Mem& memory);
+
         reg::GeneralRegisters generalRegisters; /// CPU general-purpose registers.
         reg::SegmentRegisters segmentRegisters; /// CPU segment registers.
 
@@ -84,23 +323,81 @@ namespace emu::cpu {
 
     private:
         /**
-         * @param opcode The instruction opcode.
-         * @return The decoded instruction or an empty unique pointer if decoding failed.
+         * Read the bytes of memory at the given absolute address from which an instruction may be decoded.
+         */
+        FetchWindow fetchWindow(AbsAddr address, const Mem& memory) const;
+
+        /**
+         * Read the bytes of memory at the given offset within the code segment from which an instruction may be
+         * decoded. Offsets wrap around to the start of the segment as they would for the instruction pointer.
+         */
+        FetchWindow fetchSegmentWindow(OffsetAddr ip, const Mem& memory) const;
+
+        /**
+         * Decodes an instruction from a fetch window without consulting the decode cache.
+         *
+         * @return The decoded instruction or an empty optional should the opcode be unimplemented.
+         * @throws Mem::OutOfBounds Should the instruction extend beyond the end of memory.
+         */
+        std::optional<instr::DecodedInstruction> decodeInstruction(const FetchWindow& window) const;
+
+        /**
+         * Decode the basic block beginning at the current CS:IP into the block cache.
+         *
+         * @return Pointer to the decoded block or nullptr should the first instruction of the block be invalid.
+         */
+        const BasicBlock* decodeBlock(const Mem& memory);
+
+        /**
+         * Returns the block beginning at the current CS:IP from the block cache, decoding it first if necessary.
+         *
+         * @return Pointer to the block or nullptr should the first instruction of the block be invalid.
+         */
+        const BasicBlock* fetchBlock(const Mem& memory);
+
+        /**
+         * Execute the first instructions of a block using translated code if available or the interpreter otherwise.
+         */
+        BlockResult runBlock(const BasicBlock& block, unsigned int count, Mem& memory);
+
+        /**
+         * Returns the index of the first instruction of the block at or after the given index and before the given
+         * count that is at a breakpoint, or count should there be none.
          */
-        std::unique_ptr<instr::Instruction> fetchDecodeWithoutModRegRm(const instr::Opcode& opcode) const;
+        unsigned int findBreakpoint(const BasicBlock& block, unsigned int start, unsigned int count) const;
 
         /**
-         * @param opcode The instruction opcode.
-         * @param TODO
-         * @return The coded instruction or an empty unique pointer if decoding failed.
+         * Execute the first instructions of a decoded block. Implemented in interpreter.cpp either as a loop calling
+         * through the handler table or, when built with WIRED86_THREADED_INTERPRETER, as threaded code.
+         *
+         * @param block The block to execute.
+         * @param count Number of instructions of the block to execute (at most).
+         * @return Number of instructions executed and whether all of them executed successfully.
          */
-        std::unique_ptr<instr::Instruction> fetchDecodeWithModRegRm(const instr::Opcode& opcode, AbsAddr address,
-                                                                    const Mem& memory) const;
+        BlockResult interpretBlock(const BasicBlock& block, unsigned int count, Mem& memory);
 
         /// The instruction pointer is an offset within the code segment that points to the next instruction in memory.
         OffsetAddr instructionPointer = 0;
 
         /// CPU flag register. Declared private as not all flags should be directly modifiable by all.
-        reg::Flags flags;
+        reg::LazyFlags flags;
+
+        /// Previously decoded instructions. Held on the heap as the cache tables are large. Modified by const methods
+        /// as caching does not alter the observable state of the CPU.
+        std::unique_ptr<DecodeCache> decodeCache;
+
+        /// Previously decoded basic blocks (held on the heap as the cache is large).
+        std::unique_ptr<BlockCache> blockCache;
+
+        /// Which FusedPair values are fused when decoding blocks.
+        std::array<bool, instr::FUSED_PAIR_COUNT> pairFusion = { true, true, true };
+
+        unsigned long fusedPairExecutions = 0;
+
+        /// Absolute addresses at which Intel8086::run stops.
+        std::unordered_set<AbsAddr> breakpoints;
+
+        /// Translator of hot blocks into native code (only allocated when enabled).
+        std::unique_ptr<jit::Translator> translator;
     };
 }
\ No newline at end of file
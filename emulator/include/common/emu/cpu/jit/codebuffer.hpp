@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "primitives.hpp"
+
+/*
+ * The dynamic binary translator is only available when targetting x86-64 on a platform providing mmap/mprotect.
+ */
+#if defined(__x86_64__) && defined(__unix__)
+    #define WIRED86_JIT_AVAILABLE
+#endif
+
+namespace emu::cpu::jit {
+    /**
+     * Region of host memory holding translated native code. Code is appended to the buffer while it is writable and
+     * the buffer is then made executable (but not writable) again, meaning the buffer is never both writable and
+     * executable at the same time.
+     */
+    class CodeBuffer {
+    public:
+        /**
+         * @param bufferSize Size of the buffer in bytes (rounded up to a whole number of host pages).
+         */
+        CodeBuffer(std::size_t bufferSize);
+        ~CodeBuffer();
+
+        CodeBuffer(const CodeBuffer&) = delete;
+        CodeBuffer& operator=(const CodeBuffer&) = delete;
+
+        /**
+         * Copy code into the buffer.
+         *
+         * @param code The machine code to copy.
+         * @return Pointer to the executable copy of the code or nullptr should the buffer be full (or unavailable).
+         */
+        const void* append(const std::vector<u8>& code);
+
+        /// Discard all code held in the buffer.
+        void reset();
+
+        /// Returns the number of bytes of code currently held.
+        std::size_t getUsed() const;
+
+    private:
+        u8* buffer = nullptr;
+        std::size_t size = 0, used = 0;
+    };
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <initializer_list>
+#include "primitives.hpp"
+
+namespace emu::cpu::jit {
+    /**
+     * Host general-purpose registers numbered as encoded in instructions. Only the first eight are available as the
+     * emitter never emits REX.R/REX.X/REX.B prefixes.
+     */
+    enum HostRegister : u8 {
+        RAX_HOST_REGISTER,
+        RCX_HOST_REGISTER,
+        RDX_HOST_REGISTER,
+        RBX_HOST_REGISTER,
+        RSP_HOST_REGISTER,
+        RBP_HOST_REGISTER,
+        RSI_HOST_REGISTER,
+        RDI_HOST_REGISTER
+    };
+
+    /**
+     * Conditions of conditional jumps numbered as encoded in instructions.
+     */
+    enum JumpCondition : u8 {
+        BELOW_CONDITION = 0x2, /// Unsigned less than (CF set).
+        ABOVE_OR_EQUAL_CONDITION = 0x3, /// Unsigned greater than or equal (CF clear).
+        EQUAL_CONDITION = 0x4, /// ZF set.
+        NOT_EQUAL_CONDITION = 0x5, /// ZF clear.
+        ABOVE_CONDITION = 0x7 /// Unsigned greater than (CF and ZF clear).
+    };
+
+    /**
+     * Encodes the small subset of x86-64 instructions used by translated code. Memory operands are either a base
+     * register plus an 8-bit displacement (the base may not be RSP) or a base register plus an index register (the
+     * base may not be RBP). Unless stated otherwise, register operands are 32-bit.
+     */
+    class Emitter {
+    public:
+        /// Position within the emitted code of a 32-bit relative jump offset that has yet to be resolved.
+        using Label = std::size_t;
+
+        void push(HostRegister reg); /// push reg (64-bit)
+        void pop(HostRegister reg); /// pop reg (64-bit)
+        void ret(); /// ret
+        void subRspImmediate(u8 value); /// sub rsp, value
+        void addRspImmediate(u8 value); /// add rsp, value
+
+        void movRegister64(HostRegister destination, HostRegister source); /// mov destination, source (64-bit)
+        void movRegister(HostRegister destination, HostRegister source); /// mov destination, source
+        void movImmediate(HostRegister reg, u32 value); /// mov reg, value
+
+        void load64(HostRegister destination, HostRegister base, u8 offset); /// mov destination, [base + offset]
+        void load(HostRegister destination, HostRegister base, u8 offset); /// mov destination, dword [base + offset]
+        void loadZeroExtendedWord(HostRegister destination, HostRegister base, u8 offset); /// movzx word [...]
+        void loadZeroExtendedByte(HostRegister destination, HostRegister base, u8 offset); /// movzx byte [...]
+        void storeWord(HostRegister base, u8 offset, HostRegister source); /// mov word [base + offset], source
+        void storeByte(HostRegister base, u8 offset, HostRegister source); /// mov byte [base + offset], source (AL-BL)
+        void storeWordImmediate(HostRegister base, u8 offset, u16 value); /// mov word [base + offset], value
+        void storeByteImmediate(HostRegister base, u8 offset, u8 value); /// mov byte [base + offset], value
+
+        /// movzx destination, word [base + index]
+        void loadZeroExtendedWordIndexed(HostRegister destination, HostRegister base, HostRegister index);
+        /// mov word [base + index], source
+        void storeWordIndexed(HostRegister base, HostRegister index, HostRegister source);
+        /// mov byte [base + index], value
+        void storeByteImmediateIndexed(HostRegister base, HostRegister index, u8 value);
+        /// inc dword [base + index * 4]
+        void incrementDwordIndexed(HostRegister base, HostRegister index);
+        /// inc dword [base] (the base may not be RSP or RBP)
+        void incrementDword(HostRegister base);
+
+        /// add/or/adc/sbb/and/sub/xor/cmp destination, source (function as encoded by opcode bits 3-5)
+        void alu(u8 function, HostRegister destination, HostRegister source);
+        /// add/or/adc/sbb/and/sub/xor/cmp destination, source (16-bit)
+        void aluWord(u8 function, HostRegister destination, HostRegister source);
+        /// add/or/adc/sbb/and/sub/xor/cmp destination, source (8-bit, AL-BL)
+        void aluByte(u8 function, HostRegister destination, HostRegister source);
+        /// add/or/adc/sbb/and/sub/xor/cmp reg, value (sign-extended)
+        void aluImmediate8(u8 function, HostRegister reg, u8 value);
+        /// cmp reg, value
+        void compareImmediate(HostRegister reg, u32 value);
+        /// cmp reg, dword [base + offset]
+        void compare(HostRegister reg, HostRegister base, u8 offset);
+        /// test a, b
+        void test(HostRegister a, HostRegister b);
+        /// shr reg, count
+        void shiftRightImmediate(HostRegister reg, u8 count);
+        /// lea destination, [base + offset]
+        void loadEffectiveAddress(HostRegister destination, HostRegister base, u8 offset);
+
+        void callAbsolute(const void* function); /// mov rax, function; call rax
+
+        Label jump(); /// jmp rel32 (target resolved via Emitter::bind)
+        Label jump(JumpCondition condition); /// jcc rel32 (target resolved via Emitter::bind)
+
+        /**
+         * Resolve a previously emitted jump such that it targets the current position.
+         */
+        void bind(Label label);
+
+        /**
+         * Returns the code emitted so far.
+         */
+        const std::vector<u8>& getCode() const;
+
+    private:
+        void emit(std::initializer_list<u8> bytes);
+        void emit16(u16 value);
+        void emit32(u32 value);
+        void emit64(u64 value);
+
+        /// Emit the MOD-REG-R/M byte (and displacement) of a [base + offset] operand.
+        void emitMemoryOperand(u8 reg, HostRegister base, u8 offset);
+        /// Emit the MOD-REG-R/M and SIB bytes of a [base + index * (1 << scale)] operand.
+        void emitIndexedOperand(u8 reg, HostRegister base, HostRegister index, u8 scale = 0);
+        /// Emit the MOD-REG-R/M byte of a register operand.
+        void emitRegisterOperand(u8 reg, HostRegister rm);
+
+        std::vector<u8> code;
+    };
+}
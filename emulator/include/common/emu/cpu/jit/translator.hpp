@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <exception>
+#include "emu/types.hpp"
+#include "emu/cpu/blockcache.hpp"
+#include "emu/cpu/jit/codebuffer.hpp"
+
+namespace emu::cpu {
+    class Intel8086;
+    struct BlockResult;
+}
+
+namespace emu::cpu::jit {
+    /**
+     * State shared between translated code and the rest of the emulator. Translated code addresses the members of this
+     * structure relative to a pointer to it, so it must remain standard layout.
+     */
+    struct Context {
+        u8* registers; /// The CPU's general-purpose register file, which translated code accesses in place.
+        u16 instructionPointer; /// Instruction pointer value upon leaving translated code.
+        u8 halted; /// Set to 1 by translated code when a HLT instruction is executed.
+
+        /// Last ALU operation performed by translated code (see reg::LazyFlags::record).
+        u16 aluDestination, aluSource, aluResult;
+        u8 aluOperation, aluWord;
+
+        Intel8086* cpu;
+        Mem* memory;
+
+        AbsAddr blockFirstAddress, blockLastAddress; /// Range of memory the executing block was translated from.
+        u32 blockGeneration; /// Write generation of that memory at the time of translation.
+
+        std::exception_ptr* exception; /// Holds any exception thrown by helper functions called by translated code.
+
+        /// Stack operations access memory directly should the absolute address of the word be below the limit.
+        AbsAddr stackBase, stackLimit;
+        MemValue* memoryData; /// See Memory::DirectAccess.
+        u32* regionGenerations;
+        u8* dirtyPages;
+        u32* writeCount;
+    };
+
+    /**
+     * Dynamic binary translator that compiles frequently executed ('hot') basic blocks into native x86-64 code.
+     *
+     * Register-to-register E, G instructions (other than ADC and SBB), PUSH/POP register and HLT instructions are
+     * translated. A block is translated up to the first instruction that is not supported, with the remainder of the
+     * block being left to the interpreter. Blocks whose first instruction is unsupported are never translated.
+     *
+     * Translated code loads and stores the CPU's general-purpose registers in place. The operands of the last ALU
+     * operation are recorded in the Context and passed on to the CPU's lazily evaluated flags on exit. Stack operations
+     * load and store words directly in host memory (see Memory::getDirectAccess). Should the word not be directly
+     * accessible or wrap around the end of the stack segment, translated code instead calls back into Intel8086 so that
+     * the operation behaves identically to the interpreter (including any exceptions thrown by memory accesses, which
+     * are rethrown once translated code has returned).
+     */
+    class Translator {
+    public:
+        /// Number of times a block must be executed before it is translated.
+        static constexpr unsigned int HOT_THRESHOLD = 16;
+        /// Number of entries in the translation cache (must be a power of two).
+        static constexpr std::size_t ENTRY_COUNT = 1024;
+        /// Size of the buffer holding translated code.
+        static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+
+        Translator();
+
+        /**
+         * Returns whether translation is supported on the host platform.
+         */
+        static bool isAvailable();
+
+        /**
+         * Execute a block using translated code, translating it first should it have just become hot.
+         *
+         * @param cpu The CPU executing the block.
+         * @param block The block to execute (must be the block beginning at the current CS:IP).
+         * @param memory The memory the block was decoded from.
+         * @param maxInstructions The maximum number of instructions to execute.
+         * @param result Updated with the outcome of execution should the block be executed.
+         * @return Whether the block was executed. If false, the block must instead be executed by the interpreter.
+         */
+        bool execute(Intel8086& cpu, const BasicBlock& block, Mem& memory, unsigned int maxInstructions,
+                     BlockResult& result);
+
+        /// Discard all translated code.
+        void clear();
+
+        /// Number of blocks that have been translated.
+        unsigned long getTranslationCount() const;
+        /// Number of times translated code has been executed.
+        unsigned long getNativeExecutionCount() const;
+
+    private:
+        using TranslatedCode = u32 (*)(Context* context);
+
+        struct Entry {
+            u16 codeSegment = 0;
+            OffsetAddr instructionPointer = 0;
+            u64 memoryId = 0; /// Identifier of the memory decoded from (see Memory::getId).
+            u32 generation = 0;
+
+            unsigned int executions = 0; /// Number of times the block has been executed prior to translation.
+            bool attempted = false; /// Whether translation has been attempted.
+
+            TranslatedCode code = nullptr;
+            unsigned int count = 0; /// Number of instructions covered by the translated code.
+        };
+
+        /**
+         * Translate as much of the given block as possible.
+         *
+         * @param count Set to the number of instructions translated.
+         * @return The translated code or nullptr should no instructions be translated.
+         */
+        TranslatedCode translate(const BasicBlock& block, const Mem& memory, unsigned int& count);
+
+        CodeBuffer codeBuffer;
+        std::array<Entry, ENTRY_COUNT> entries;
+
+        unsigned long translationCount = 0, nativeExecutionCount = 0;
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "primitives.hpp"
+#include "emu/cpu/reg/registers8086.hpp"
+
+namespace emu::cpu::reg {
+    /**
+     * ALU operations whose effect on the status flags can be deferred by LazyFlags. Operations that share rules for
+     * calculating the flags (such as AND, OR and XOR) share a value.
+     */
+    enum AluOperation : u8 {
+        NO_ALU_OPERATION, /// No operation pending - all flags are held in materialised form.
+        ADD_OPERATION,
+        ADC_OPERATION,
+        SUB_OPERATION, /// Also used by CMP.
+        SBB_OPERATION,
+        LOGIC_OPERATION /// AND, OR, XOR and TEST (CF and OF cleared, AF undefined).
+    };
+
+    /**
+     * Holds the CPU flags, deferring calculation of the status flags (CF, PF, AF, ZF, SF and OF) affected by ALU
+     * operations until they are actually read. Executing an ALU instruction merely records the operation, its operands,
+     * result and width - individual flags are only materialised when needed (e.g. by a conditional jump, PUSHF or the
+     * GUI).
+     */
+    class LazyFlags {
+    public:
+        /**
+         * Record an ALU operation, replacing the status flags resulting from any previously recorded operation.
+         *
+         * @param operation The operation performed.
+         * @param word Whether the operation was performed on 16-bit (rather than 8-bit) operands.
+         * @param destination The destination operand prior to the operation.
+         * @param source The source operand.
+         * @param result The result of the operation (truncation to the operation width is not required).
+         */
+        void record(AluOperation operation, bool word, u16 destination, u16 source, u16 result) {
+            if(operation == ADC_OPERATION || operation == SBB_OPERATION) carryIn = get(CARRY_FLAG);
+
+            u16 mask = word ? 0xFFFF : 0xFF;
+
+            pendingOperation = operation;
+            pendingWord = word;
+            pendingDestination = destination & mask;
+            pendingSource = source & mask;
+            pendingResult = result & mask;
+        }
+
+        /**
+         * Get the value of a flag, calculating it from the last recorded ALU operation if necessary.
+         */
+        bool get(Flag flag) const;
+
+        /**
+         * Set the value of a flag. Any status flags still pending calculation are materialised first so that they are
+         * unaffected.
+         */
+        void set(Flag flag, bool value);
+
+        /**
+         * Returns the value of the FLAGS register (as pushed by PUSHF), calculating any pending status flags.
+         */
+        u16 getWord() const;
+
+        /**
+         * Set every flag at once from a FLAGS register value (as popped by POPF). Any pending operation is discarded.
+         */
+        void setWord(u16 value);
+
+        /**
+         * Returns the operation that the status flags will be calculated from (NO_ALU_OPERATION if none are pending).
+         */
+        AluOperation getPendingOperation() const;
+
+    private:
+        /**
+         * Returns whether the flag is one of the status flags affected by ALU operations.
+         */
+        static bool isStatusFlag(Flag flag);
+
+        /**
+         * Calculate the value of a status flag from the pending operation.
+         */
+        bool calculate(Flag flag) const;
+
+        /**
+         * Store the values of all status flags calculated from the pending operation.
+         */
+        void materialise();
+
+        Flags flags; /// Materialised flag values held in the layout of the FLAGS register.
+
+        AluOperation pendingOperation = NO_ALU_OPERATION;
+        bool pendingWord = false;
+        bool carryIn = false; /// Carry flag prior to a pending ADC/SBB operation.
+        u16 pendingDestination = 0, pendingSource = 0, pendingResult = 0;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <map>
+#include <array>
+#include <cstddef>
+#include <string>
 #include "primitives.hpp"
 #include "convert.hpp"
 
@@ -8,12 +10,14 @@ namespace emu::cpu::reg {
     enum RegisterPart { FULL_WORD, LOW_BYTE, HIGH_BYTE };
 
     /**
-     * Generic class template for a collection of registers.
+     * Generic class template for a collection of registers. Register values are held in a flat array indexed directly
+     * by register index.
      *
      * @tparam Index Type of indexes for specifying the desired register (should be a RegisterIndex index).
      * @tparam Value Type of value stored in each register (usually numerical).
+     * @tparam Count Number of registers (all indexes must be less than this).
      */
-    template <typename Index, typename Value>
+    template <typename Index, typename Value, std::size_t Count>
     class Registers {
     public:
         /**
@@ -22,15 +26,7 @@ namespace emu::cpu::reg {
          * @param index The index of the register to get.
          * @return The value stored at the specified register.
          */
-        Value get(Index index) const {
-            // Cannot have method declared `const` when using the operator[] as that method of indexing will create a
-            // default constructed value if one is not found at the index (thus modifying `this`). As such, the map will
-            // be searched for the index and will return a default value should a value not be found.
-            auto value = regs.find(index);
-
-            if(value != regs.end()) return value->second;
-            else return Value(); // Return default-constructed value if no actual value is found in map.
-        }
+        Value get(Index index) const { return regs[index]; }
 
         /**
          * Register value setter.
@@ -49,75 +45,100 @@ namespace emu::cpu::reg {
         virtual std::string getAssemblyIdentifier(Index index) const = 0;
 
     private:
-        std::map<Index, Value> regs;
+        std::array<Value, Count> regs = {}; /// All registers are initially default-constructed (i.e. zero).
     };
 
-    template <typename Index>
-    class RegistersLowHigh : public Registers<Index, u16> {
+    /**
+     * Collection of 16-bit registers whose low and high bytes may also be accessed individually (such as AX, AL and
+     * AH). Registers are stored as a flat array of bytes in little endian order so that each byte is directly
+     * addressable and no register access requires more than a single load or store.
+     *
+     * @tparam Index Type of indexes for specifying the desired register.
+     * @tparam Count Number of registers (all indexes must be less than this).
+     */
+    template <typename Index, std::size_t Count>
+    class RegistersLowHigh {
     public:
-        using Registers<Index, u16>::get;
-        using Registers<Index, u16>::set;
+        /**
+         * Get the full 16-bit value of a register.
+         */
+        u16 get(Index index) const {
+            return convert::createWordFromBytes(bytes[index * 2], bytes[index * 2 + 1]);
+        }
 
         /**
-         * Get least significant byte of 16-bit register.
+         * Set the full 16-bit value of a register.
          */
-        u8 getLow(Index index) const {
-            u16 value = get(index);
-            return convert::getLeastSigByte(value);
+        void set(Index index, u16 value) {
+            bytes[index * 2] = convert::getLeastSigByte(value);
+            bytes[index * 2 + 1] = convert::getMostSigByte(value);
         }
 
+        /**
+         * Get least significant byte of 16-bit register.
+         */
+        u8 getLow(Index index) const { return bytes[index * 2]; }
+
         /**
          * Get most significant byte of 16-bit register.
          */
-        u8 getHigh(Index index) const {
-            u16 value = get(index);
-            return convert::getMostSigByte(value);
-        }
+        u8 getHigh(Index index) const { return bytes[index * 2 + 1]; }
 
         /**
          * Fetch a specific part of a register. Note that return value will always be 16-bit wide even if only a single
          * byte of a register is accessed.
          */
         u16 get(Index index, RegisterPart part) const {
-            switch(part) {
-            case LOW_BYTE: return getLow(index);
-            case HIGH_BYTE: return getHigh(index);
-            default: return get(index);
-            }
+            return part == FULL_WORD ? get(index) : bytes[getByteOffset(index, part)];
         }
 
         /**
          * Set least significant byte of 16-bit register (most significant byte unaffected).
          */
-        void setLow(Index index, u8 low) {
-            u16 high = getHigh(index);
-            u16 value = convert::createWordFromBytes(low, high);
-            set(index, value);
-        }
+        void setLow(Index index, u8 low) { bytes[index * 2] = low; }
 
         /**
          * Set most significant byte of 16-bit register (least significant byte unaffected).
          */
-        void setHigh(Index index, u8 high) {
-            u16 low = getLow(index);
-            u16 value = convert::createWordFromBytes(low, high);
-            set(index, value);
-        }
+        void setHigh(Index index, u8 high) { bytes[index * 2 + 1] = high; }
 
         /**
          * Set a specific part of a register. Note that the value argument is 16-bit wide but will be cast to 8-bits
          * when only a setting a high or low byte of a register and not the entire 16-bit value.
          */
         void set(Index index, RegisterPart part, u16 value) {
-            u8 byte = static_cast<u8>(value);
+            if(part == FULL_WORD) set(index, value);
+            else bytes[getByteOffset(index, part)] = static_cast<u8>(value);
+        }
 
-            switch(part) {
-            case LOW_BYTE: setLow(index, byte); break;
-            case HIGH_BYTE: setHigh(index, byte); break;
-            default: set(index, value);
-            }
+        /**
+         * Returns the offset within the register file of the given byte of a register (must not be FULL_WORD).
+         */
+        static constexpr std::size_t getByteOffset(Index index, RegisterPart part) {
+            return index * 2 + (part == HIGH_BYTE ? 1 : 0);
         }
 
+        /**
+         * Returns the register file (each register as two bytes in little endian order).
+         */
+        const std::array<u8, Count * 2>& getBytes() const { return bytes; }
+
+        /**
+         * Replace the contents of the entire register file (see RegistersLowHigh::getBytes).
+         */
+        void setBytes(const std::array<u8, Count * 2>& values) { bytes = values; }
+
+        /**
+         * Returns a pointer to the register file through which registers may be accessed in place (such as by
+         * translated code).
+         */
+        u8* getData() { return bytes.data(); }
+
+        /**
+         * Get the assembly identifier of the specified register. Is pure virtual and must be overriden by subclasses.
+         */
+        virtual std::string getAssemblyIdentifier(Index index) const = 0;
+
         /**
          * Get the assembly identifier of a specific register index and part.
          *
@@ -126,5 +147,8 @@ namespace emu::cpu::reg {
          * @return String assembly identifier.
          */
         virtual std::string getAssemblyIdentifier(Index index, RegisterPart part) const = 0;
+
+    private:
+        alignas(16) std::array<u8, Count * 2> bytes = {};
     };
-}
\ No newline at end of file
+}
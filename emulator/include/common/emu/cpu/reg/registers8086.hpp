@@ -15,7 +15,9 @@ namespace emu::cpu::reg {
         STACK_POINTER
     };
 
-    class GeneralRegisters : public RegistersLowHigh<GeneralRegister> {
+    constexpr std::size_t GENERAL_REGISTER_COUNT = 8;
+
+    class GeneralRegisters : public RegistersLowHigh<GeneralRegister, GENERAL_REGISTER_COUNT> {
     public:
         std::string getAssemblyIdentifier(GeneralRegister index) const override final;
         std::string getAssemblyIdentifier(GeneralRegister index, RegisterPart part) const override final;
@@ -28,25 +30,91 @@ namespace emu::cpu::reg {
         STACK_SEGMENT
     };
 
-    class SegmentRegisters : public Registers<SegmentRegister, u16> {
+    constexpr std::size_t SEGMENT_REGISTER_COUNT = 4;
+
+    /**
+     * Segment registers alongside the base address of each segment (the register value shifted left by 4), which is
+     * calculated whenever a register is written so that resolving an address requires only a single addition.
+     */
+    class SegmentRegisters : public Registers<SegmentRegister, u16, SEGMENT_REGISTER_COUNT> {
     public:
+        /**
+         * Set the value of a segment register and calculate the base address of the segment. Hides Registers::set so
+         * that the base address can never be out of date.
+         */
+        void set(SegmentRegister index, u16 value) {
+            Registers::set(index, value);
+            bases[index] = static_cast<u32>(value) << 4;
+        }
+
+        /**
+         * Returns the absolute address at which the segment begins.
+         */
+        u32 getBase(SegmentRegister index) const { return bases[index]; }
+
         std::string getAssemblyIdentifier(SegmentRegister index) const override final;
+
+    private:
+        std::array<u32, SEGMENT_REGISTER_COUNT> bases = {};
     };
 
+    /**
+     * CPU flags. The value of each is the position of its bit within the 16-bit FLAGS register.
+     */
     enum Flag {
-        CARRY_FLAG,
-        PARITY_FLAG,
-        AUX_CARRY_FLAG,
-        ZERO_FLAG,
-        SIGN_FLAG,
-        TRAP_FLAG,
-        INTERRUPT_FLAG,
-        DIRECTION_FLAG,
-        OVERFLOW_FLAG
+        CARRY_FLAG = 0,
+        PARITY_FLAG = 2,
+        AUX_CARRY_FLAG = 4,
+        ZERO_FLAG = 6,
+        SIGN_FLAG = 7,
+        TRAP_FLAG = 8,
+        INTERRUPT_FLAG = 9,
+        DIRECTION_FLAG = 10,
+        OVERFLOW_FLAG = 11
     };
 
-    class Flags : public Registers<Flag, bool> {
+    /**
+     * Returns the mask of the bit holding the given flag within the FLAGS register.
+     */
+    constexpr u16 getFlagMask(Flag flag) {
+        return static_cast<u16>(1 << flag);
+    }
+
+    /// Bits of the FLAGS register that hold a flag.
+    constexpr u16 DEFINED_FLAG_BITS = 0b0000111111010101;
+
+    /// Bits of the FLAGS register that do not hold a flag but always read as set on the 8086.
+    constexpr u16 RESERVED_FLAG_BITS = 0b1111000000000010;
+
+    /**
+     * The FLAGS register held as a single 16-bit word using the bit layout of the 8086, so that it may be saved and
+     * restored (e.g. by PUSHF and POPF) in its entirety without any conversion.
+     */
+    class Flags {
     public:
-        std::string getAssemblyIdentifier(Flag) const override final;
+        bool get(Flag flag) const {
+            return (word & getFlagMask(flag)) != 0;
+        }
+
+        void set(Flag flag, bool value) {
+            word = static_cast<u16>(value ? word | getFlagMask(flag) : word & ~getFlagMask(flag));
+        }
+
+        /**
+         * Returns the value of the FLAGS register as read by the 8086 (reserved bits included).
+         */
+        u16 getWord() const {
+            return word | RESERVED_FLAG_BITS;
+        }
+
+        /**
+         * Set every flag at once from a FLAGS register value (reserved bits are ignored).
+         */
+        void setWord(u16 value) {
+            word = value & DEFINED_FLAG_BITS;
+        }
+
+    private:
+        u16 word = 0;
     };
-}
\ No newline at end of file
+}
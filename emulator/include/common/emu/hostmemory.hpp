@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "primitives.hpp"
+
+/*
+ * Host memory may only be mapped directly (rather than simply allocated) on platforms providing mmap.
+ */
+#if defined(__unix__)
+    #define WIRED86_HOST_MAPPING_AVAILABLE
+#endif
+
+namespace emu {
+    /**
+     * Zero-initialised block of host memory backing emulator memory. Where the platform allows, the block is a
+     * private anonymous mapping spanning a whole number of host pages. Such memory is zeroed on demand by the host, so
+     * pages only become resident once first accessed (meaning allocation costs the same regardless of size), and files
+     * may be mapped directly over parts of it rather than copied in.
+     */
+    class HostMemory {
+    public:
+        /**
+         * @param bytes Size of the block in bytes.
+         * @throws std::bad_alloc Should the memory not be allocated.
+         */
+        HostMemory(std::size_t bytes);
+        ~HostMemory();
+
+        HostMemory(const HostMemory&) = delete;
+        HostMemory& operator=(const HostMemory&) = delete;
+
+        /**
+         * Returns whether files can be mapped into host memory on this platform.
+         */
+        static bool isMappingAvailable();
+
+        /**
+         * Returns the size of a host page (the granularity of mappings) in bytes.
+         */
+        static std::size_t getPageSize();
+
+        /**
+         * Map as many whole pages of a file as fit over the block beginning at the given offset. Mappings are private,
+         * so writes to writable mappings are never written back to the file (copy-on-write).
+         *
+         * @param path Path of the file to map.
+         * @param offset Offset within the block at which to map the file (must be a multiple of the page size).
+         * @param readOnly Whether the mapped pages are made read-only. Writing to them will crash the host process, so
+         *        the owner of the block must prevent any such writes.
+         * @return Number of bytes mapped from the start of the file (0 should mapping not be possible, in which case
+         *         the block is unchanged). The file is checked to be a regular file that can be mapped before the block
+         *         is touched, so the block only loses the contents of the range should the host fail to map a file it
+         *         has just mapped successfully elsewhere.
+         */
+        std::size_t mapFile(const std::string& path, std::size_t offset, bool readOnly);
+
+        /**
+         * Zero the entire block. Where the block is a mapping, its pages are simply replaced by fresh zero-on-demand
+         * pages (releasing any that were resident and removing any mapped files) rather than written to.
+         */
+        void zero();
+
+        u8* getData() const;
+        std::size_t getSize() const;
+
+    private:
+        std::size_t size; /// Size requested.
+        std::size_t mappedSize = 0; /// Size actually mapped (whole pages) or 0 should the block not be a mapping.
+
+        u8* data = nullptr;
+        std::unique_ptr<u8[]> allocation; /// Holds the block should it not be a mapping.
+    };
+}
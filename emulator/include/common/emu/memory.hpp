@@ -2,14 +2,23 @@
 
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include <atomic>
 #include <stdexcept>
 #include <fstream>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include "convert.hpp"
+#include "emu/hostmemory.hpp"
 
 namespace emu {
     template <typename Value, typename Address>
     class Memory {
+        static_assert(std::is_trivially_copyable_v<Value>,
+                      "Values are zero-initialised and copied in bulk so must be trivially copyable.");
+
     public:
         /**
          * Exception thrown when a call to read or write is supplied with an address that is out of bounds.
@@ -23,8 +32,80 @@ namespace emu {
             const Address address;
         };
 
+        /**
+         * Device whose registers are accessed through memory (memory-mapped I/O) rather than host memory (see
+         * Memory::attachDevice).
+         */
+        class Device {
+        public:
+            virtual ~Device() = default;
+
+            /**
+             * @param address The address read relative to the start of the region the device is attached to.
+             * @return The value read.
+             */
+            virtual Value read(Address address) = 0;
+
+            /**
+             * @param address The address written relative to the start of the region the device is attached to.
+             * @param value The value written.
+             */
+            virtual void write(Address address, Value value) = 0;
+        };
+
     public:
-        Memory(Address memorySize) : size(memorySize), mem(new Value[size]) { fill(); }
+        /**
+         * How accesses to addresses beyond the end of memory are handled (see Memory::setAccessMode).
+         */
+        enum AccessMode : u8 {
+            CHECKED_ACCESS, /// Accesses beyond the end of memory throw OutOfBounds (the default).
+            WRAPPED_ACCESS, /// Addresses are masked. Accesses beyond the end of memory are faults (see getFaultCount).
+            MIRRORED_ACCESS /// Addresses are masked and then mirrored throughout the address space (never faults).
+        };
+
+        /// Writes to memory are tracked in regions of this many values (see Memory::getGeneration).
+        static constexpr unsigned int REGION_SHIFT = 6;
+        static constexpr Address REGION_SIZE = 1 << REGION_SHIFT;
+
+        /// Snapshots copy memory in pages of this many values (see Memory::createSnapshot).
+        static constexpr unsigned int PAGE_SHIFT = 12;
+        static constexpr Address PAGE_SIZE = 1 << PAGE_SHIFT;
+
+        /// Identifies a snapshot of memory.
+        using SnapshotId = u32;
+
+        /// Identifies the point at which memory was last saved to (or loaded from) a delta file (see
+        /// Memory::saveDeltaToFile).
+        using SaveToken = u32;
+
+        /// Token preceding every modification, such that every page is considered modified since it.
+        static constexpr SaveToken INITIAL_SAVE_TOKEN = 0;
+
+        /**
+         * Internals of memory through which code generated at runtime (see cpu::jit::Translator) may access values
+         * directly rather than through the read and write methods (see Memory::getDirectAccess).
+         */
+        struct DirectAccess {
+            Value* data; /// The values held in memory.
+            u32* regionGenerations; /// To be incremented for every region written to (see Memory::getGeneration).
+            u8* dirtyPages; /// To be set to 1 for every page written to (see Memory::isPageModified).
+            u32* writeCount; /// To be incremented for every write (see Memory::getWriteCount).
+            Address limit; /// Only addresses below this may be accessed directly.
+        };
+
+        /// Version passed to Memory::loadDeltaFromFile to load the latest version saved.
+        static constexpr u32 LATEST_VERSION = ~u32(0);
+
+        /**
+         * @param memorySize Number of values in memory. All are initially 0 but host memory is only committed to them
+         *        once accessed (see HostMemory), so the cost of construction does not depend upon the size.
+         */
+        Memory(Address memorySize)
+        : size(memorySize), storage(size * sizeof(Value)), mem(reinterpret_cast<Value*>(storage.getData())),
+          regionGenerations((size >> REGION_SHIFT) + 1, 0), pageSnapshots((size >> PAGE_SHIFT) + 1, 0),
+          dirtyPages(getPageCount(), 0), pageSaves(getPageCount(), 0), pageTable(getPageCount()) {
+            for(Address page = 0; page < getPageCount(); page++) mapPage(page);
+        }
 
         /**
          * Check if the address passed is within bounds of the memory allocated.
@@ -37,13 +118,50 @@ namespace emu {
         }
 
         /**
-         * Fill all memory with the specified value (defaults to 0).
+         * Set how addresses are treated by every access. In the wrapped and mirrored modes, addresses are first masked
+         * (e.g. to 20 bits so that they wrap around at 1 MiB like those of the 8086). Addresses that are still beyond
+         * the end of memory are then either faults or wrap around to the start of memory, so that memory smaller than
+         * the address space is mirrored throughout it. Faulting reads return 0 and faulting writes are ignored - rather
+         * than throwing an exception, the fault is recorded and may be checked for afterwards.
+         *
+         * @param mode The access mode.
+         * @param mask Mask applied to addresses in the wrapped and mirrored modes.
+         */
+        void setAccessMode(AccessMode mode, Address mask = ~Address(0)) {
+            accessMode = mode;
+            addressMask = mask;
+        }
+
+        AccessMode getAccessMode() const { return accessMode; }
+
+        /**
+         * Returns the number of accesses that have faulted (only possible in wrapped access mode). Comparing counts
+         * before and after an operation reveals whether any access made by it faulted.
+         */
+        u32 getFaultCount() const { return faultCount; }
+
+        /**
+         * Returns the (masked) address of the most recent faulting access.
+         */
+        Address getLastFaultAddress() const { return lastFaultAddress; }
+
+        /**
+         * Fill all memory with the specified value (defaults to 0) in bulk. Read-only data and regions attached to
+         * devices are left unmodified. Filling with 0 releases host memory rather than writing to it where possible.
          *
          * @param value Value to fill memory with.
          */
         void fill(Value value = 0) {
-            for(Address addr = 0; addr < size; addr++)
-                write(addr, value);
+            prepareWrite(0, size);
+
+            if(value == Value() && readOnlyRanges.empty() && devices.empty()) storage.zero();
+            else {
+                forEachWritableRange(0, size - 1, [this, value](Address start, Address amount) {
+                    std::fill(mem + start, mem + start + amount, value);
+                });
+            }
+
+            touchRegions(0, size);
         }
 
         /**
@@ -53,8 +171,31 @@ namespace emu {
          * @return The value read.
          */
         Value read(Address address) const {
-            assertWithinBounds(address);
-            return mem[address];
+            if(!mapAddress(address)) return 0;
+
+            const PageMapping& page = pageTable[address >> PAGE_SHIFT];
+            if(page.read) return page.read[address & (PAGE_SIZE - 1)];
+
+            return page.device->read(address - page.deviceStart);
+        }
+
+        /**
+         * Read two consecutive values as a little-endian 16-bit word with a single bounds check. Only meaningful for
+         * memory holding 8-bit values.
+         *
+         * @param address The address of the least significant value (the most significant is at the next address).
+         * @return The word read.
+         */
+        u16 readWord(Address address) const {
+            if(accessMode == CHECKED_ACCESS && (address & (PAGE_SIZE - 1)) != PAGE_SIZE - 1) { // Within a single page.
+                assertWithinBounds(address + 1);
+
+                const Value* values = pageTable[address >> PAGE_SHIFT].read;
+                if(values) return convert::createWordFromBytes(values[address & (PAGE_SIZE - 1)],
+                                                               values[(address & (PAGE_SIZE - 1)) + 1]);
+            }
+
+            return convert::createWordFromBytes(read(address), read(address + 1));
         }
 
         /**
@@ -81,14 +222,106 @@ namespace emu {
         }
 
         /**
-         * Write a value to memory at the given address.
+         * Copy a range of values into a buffer with a single bounds check rather than one per value. Should the range
+         * extend beyond the end of memory, only the values up to the end of memory are copied. In the wrapped and
+         * mirrored access modes, every value is read as if by Memory::read so all are always copied. Values within
+         * pages attached to devices are also read individually.
+         *
+         * @param startAddress The address of the first value to copy (must be within bounds).
+         * @param buffer Buffer of at least amount values to copy into.
+         * @param amount Maximum number of values to copy.
+         * @return Number of values actually copied.
+         */
+        Address readInto(Address startAddress, Value* buffer, Address amount) const {
+            if(accessMode != CHECKED_ACCESS) {
+                for(Address offset = 0; offset < amount; offset++) buffer[offset] = read(startAddress + offset);
+                return amount;
+            }
+
+            assertWithinBounds(startAddress);
+
+            Address count = std::min<Address>(amount, size - startAddress);
+
+            for(Address offset = 0; offset < count;) { // Copy a page at a time.
+                Address address = startAddress + offset;
+                Address pageOffset = address & (PAGE_SIZE - 1);
+                Address pageCount = std::min<Address>(count - offset, PAGE_SIZE - pageOffset);
+
+                const PageMapping& page = pageTable[address >> PAGE_SHIFT];
+
+                if(page.read) std::copy(page.read + pageOffset, page.read + pageOffset + pageCount, buffer + offset);
+                else {
+                    for(Address i = 0; i < pageCount; i++)
+                        buffer[offset + i] = page.device->read(address + i - page.deviceStart);
+                }
+
+                offset += pageCount;
+            }
+
+            return count;
+        }
+
+        /**
+         * Write a value to memory at the given address. Writes to read-only data are ignored.
          *
          * @param address The address to be written to.
          * @param value The value to write.
          */
         void write(Address address, Value value) {
-            assertWithinBounds(address);
-            mem[address] = value;
+            if(!mapAddress(address)) return;
+
+            PageMapping& page = pageTable[address >> PAGE_SHIFT];
+
+            if(page.write) {
+                prepareWrite(address);
+                page.write[address & (PAGE_SIZE - 1)] = value;
+            }
+            else if(page.device) {
+                page.device->write(address - page.deviceStart, value);
+                return;
+            }
+            else if(isReadOnly(address)) return;
+            else { // Page only partially read-only.
+                prepareWrite(address);
+                mem[address] = value;
+            }
+
+            regionGenerations[address >> REGION_SHIFT]++;
+            dirtyPages[address >> PAGE_SHIFT] = 1;
+            writeCount++;
+        }
+
+        /**
+         * Write a 16-bit word as two consecutive little-endian values with a single bounds check (see readWord).
+         *
+         * @param address The address to which the least significant value is written.
+         * @param value The word to write.
+         */
+        void writeWord(Address address, u16 value) {
+            // Only words within a single page of plain RAM are written directly:
+            Value* values = nullptr;
+
+            if(accessMode == CHECKED_ACCESS && (address & (PAGE_SIZE - 1)) != PAGE_SIZE - 1) {
+                assertWithinBounds(address + 1);
+                values = pageTable[address >> PAGE_SHIFT].write;
+            }
+
+            if(!values) {
+                write(address, convert::getLeastSigByte(value));
+                write(address + 1, convert::getMostSigByte(value));
+                return;
+            }
+
+            prepareWrite(address);
+
+            values[address & (PAGE_SIZE - 1)] = convert::getLeastSigByte(value);
+            values[(address & (PAGE_SIZE - 1)) + 1] = convert::getMostSigByte(value);
+
+            regionGenerations[address >> REGION_SHIFT]++;
+            if(((address + 1) & (REGION_SIZE - 1)) == 0) regionGenerations[(address + 1) >> REGION_SHIFT]++;
+
+            dirtyPages[address >> PAGE_SHIFT] = 1;
+            writeCount++;
         }
 
         /**
@@ -110,37 +343,188 @@ namespace emu {
         }
 
         /**
-         * Load data from a binary file into emulator memory.
+         * Load data from a binary file into emulator memory. Read-only data and regions attached to devices are left
+         * unmodified (the corresponding data in the file is skipped).
          *
          * @param path The path of the file from which data should be loaded.
          * @param offset The offset in memory to which data should be loaded.
          * @return Whether the file could be opened successfully or not.
          */
         bool loadFromFile(std::string path, Address offset = 0) {
-            std::ifstream file;
+            return copyFromFile(path, offset, 0);
+        }
 
-            file.open(path,
-                      std::ios::in | // Input/read mode.
-                      std::ios::binary | // Binary mode.
-                      std::ios::ate); // Place cursor at end of file st that tellg will return file size.
+        /**
+         * Load data from a binary file by mapping it directly into the host memory backing emulator memory, meaning
+         * that the cost of loading does not depend upon the size of the file. Only whole host pages can be mapped -
+         * the remainder of the file, or all of it should mapping not be possible (e.g. the offset is not page aligned
+         * or the platform does not support it), is copied into memory as by Memory::loadFromFile.
+         *
+         * Mapped data is private to this memory (copy-on-write) so the file itself is never modified. While snapshots
+         * exist, data is always copied so that the previous contents of memory are saved.
+         *
+         * @param path The path of the file from which data should be loaded.
+         * @param offset The offset in memory to which data should be loaded. Read-only data and regions attached to
+         *        devices are left unmodified as by Memory::loadFromFile (and nothing is mapped should any follow the
+         *        offset).
+         * @param readOnly Whether the loaded data is read-only (such as a ROM image), in which case writes to it are
+         *        ignored.
+         * @return Whether the file could be opened successfully or not.
+         */
+        bool mapFromFile(std::string path, Address offset = 0, bool readOnly = false) {
+            if(size <= offset) return false;
 
-            if(file.is_open() && size > offset) {
-                Address fileSize = file.tellg();
-                Address readSize = std::min(fileSize, size - offset);
+            // Mapping would replace host memory holding read-only data or data behind devices, so is only done should
+            // there be none from the offset onwards:
+            bool mappable = snapshots.empty() && !overlapsReadOnly(offset, size - 1) &&
+                            std::none_of(devices.begin(), devices.end(),
+                                         [offset](const AttachedDevice& other) { return other.lastAddress >= offset; });
 
-                if(readSize > 0) {
-                    file.seekg(0, std::ios::beg);
-                    auto ptr = reinterpret_cast<char*>(mem.get() + offset);
-                    file.read(ptr, readSize);
-                }
+            std::size_t byteOffset = static_cast<std::size_t>(offset) * sizeof(Value);
+            std::size_t mappedBytes = mappable ? storage.mapFile(path, byteOffset, readOnly) : 0;
+            Address mapped = static_cast<Address>(mappedBytes / sizeof(Value));
 
-                file.close();
-                return true;
+            touchRegions(offset, mapped);
+
+            Address copied = 0;
+            if(!copyFromFile(path, offset + mapped, mappedBytes, &copied) && mapped == 0) return false;
+
+            if(readOnly && mapped + copied > 0) {
+                readOnlyRanges.emplace_back(offset, offset + mapped + copied - 1);
+                std::sort(readOnlyRanges.begin(), readOnlyRanges.end());
+
+                mapPages(offset, offset + mapped + copied - 1);
             }
 
+            return true;
+        }
+
+        /**
+         * Returns whether the value at the given address is read-only (see Memory::mapFromFile).
+         */
+        bool isReadOnly(Address address) const {
+            if(readOnlyRanges.empty()) return false;
+
+            for(const auto& range : readOnlyRanges)
+                if(address >= range.first && address <= range.second) return true;
+
             return false;
         }
 
+        /**
+         * Attach a device to a region of memory so that accesses to it are handled by the device rather than going to
+         * host memory. Memory is divided into pages which are each either RAM, ROM (see Memory::mapFromFile) or device
+         * registers, so every access costs only a lookup of its page plus a pointer dereference in the case of RAM and
+         * ROM. Devices must therefore be attached to whole pages. The values held by host memory in the region are
+         * left unmodified but are inaccessible while the device is attached.
+         *
+         * Device registers are not tracked by write generations so the region should not contain instructions.
+         *
+         * @param device The device, which must remain alive while attached.
+         * @param startAddress The first address of the region (must be a multiple of PAGE_SIZE).
+         * @param amount Number of values in the region (must be a multiple of PAGE_SIZE unless it extends to the end of
+         *        memory).
+         * @return Whether the device could be attached (false should the region not be made up of whole pages within
+         *         bounds, or should it overlap read-only data or another device).
+         */
+        bool attachDevice(Device& device, Address startAddress, Address amount) {
+            Address lastAddress = startAddress + amount - 1;
+
+            if(amount == 0 || (startAddress & (PAGE_SIZE - 1)) != 0 || lastAddress < startAddress ||
+               lastAddress >= size || (((lastAddress + 1) & (PAGE_SIZE - 1)) != 0 && lastAddress != size - 1))
+                return false;
+
+            if(overlapsReadOnly(startAddress, lastAddress)) return false;
+
+            for(const auto& attached : devices)
+                if(attached.firstAddress <= lastAddress && attached.lastAddress >= startAddress) return false;
+
+            devices.push_back({ &device, startAddress, lastAddress });
+            mapPages(startAddress, lastAddress);
+
+            return true;
+        }
+
+        /**
+         * Detach a device from every region of memory it is attached to, which once again become RAM.
+         *
+         * @return Whether the device was attached.
+         */
+        bool detachDevice(const Device& device) {
+            auto attached = std::partition(devices.begin(), devices.end(),
+                                           [&device](const AttachedDevice& other) { return other.device != &device; });
+            if(attached == devices.end()) return false;
+
+            std::vector<AttachedDevice> detached(attached, devices.end());
+            devices.erase(attached, devices.end());
+
+            for(const auto& region : detached) mapPages(region.firstAddress, region.lastAddress);
+            return true;
+        }
+
+        /**
+         * Take a snapshot of the current contents of memory that may later be restored. Takes constant time as nothing
+         * is copied up front - instead, each page is copied the first time it is written to after the snapshot was
+         * taken (copy-on-write). Read-only data is never included.
+         *
+         * @return Identifier of the snapshot.
+         */
+        SnapshotId createSnapshot() {
+            snapshots.push_back({ ++lastSnapshotId, {} });
+            return lastSnapshotId;
+        }
+
+        /**
+         * Restore the contents of memory to those at the time a snapshot was taken. Takes time proportional to the
+         * number of pages written to since. The snapshot may be restored again later but any taken after it are
+         * released.
+         *
+         * @return Whether the snapshot exists.
+         */
+        bool restoreSnapshot(SnapshotId id) {
+            auto target = findSnapshot(id);
+            if(target == snapshots.end()) return false;
+
+            // A page holds the contents it had when the target was taken in the oldest snapshot since that copied it
+            // (or already holds them should none have), so pages are restored from the newest snapshot to the oldest:
+            for(auto snapshot = snapshots.end(); snapshot != target;) {
+                --snapshot;
+
+                for(const auto& [page, values] : snapshot->pages) restorePage(page, values);
+            }
+
+            snapshots.erase(target + 1, snapshots.end());
+            return true;
+        }
+
+        /**
+         * Release a snapshot that is no longer needed. Pages it copied are handed to the snapshot taken before it
+         * (unless copied by that snapshot itself) as that snapshot depends upon them.
+         *
+         * @return Whether the snapshot existed.
+         */
+        bool releaseSnapshot(SnapshotId id) {
+            auto snapshot = findSnapshot(id);
+            if(snapshot == snapshots.end()) return false;
+
+            if(snapshot != snapshots.begin()) {
+                auto previous = snapshot - 1;
+
+                for(auto& [page, values] : snapshot->pages) {
+                    previous->pages.try_emplace(page, std::move(values));
+                    if(pageSnapshots[page] == id) pageSnapshots[page] = previous->id;
+                }
+            }
+
+            snapshots.erase(snapshot);
+            return true;
+        }
+
+        /**
+         * Returns the number of snapshots currently held.
+         */
+        std::size_t getSnapshotCount() const { return snapshots.size(); }
+
         /**
          * Save all data in emulator memory to a binary file.
          *
@@ -157,7 +541,7 @@ namespace emu {
                       std::ios::trunc); // Overwrite existing file contents should it already exist.
 
             if(file.is_open()) {
-                auto ptr = reinterpret_cast<char*>(mem.get());
+                auto ptr = reinterpret_cast<char*>(mem);
                 file.write(ptr, size);
 
                 file.close();
@@ -167,9 +551,321 @@ namespace emu {
             return false;
         }
 
+        /**
+         * Save only the pages of memory modified since a previous save by appending them to a delta file, meaning that
+         * the cost of saving is proportional to the amount of memory written to. Each call appends a new version from
+         * which memory may later be rebuilt by Memory::loadDeltaFromFile. Should the file not yet exist (or be empty),
+         * the first version holds all pages.
+         *
+         * Memory may be saved to several delta files by keeping a separate token for each (every page is modified
+         * since INITIAL_SAVE_TOKEN), as the token identifies the point at which that particular file was last saved to.
+         *
+         * @param path The path of the delta file to append to.
+         * @param since Token returned by the previous save to (or load from) the file, which is replaced by one
+         *        identifying this save should it succeed.
+         * @return Whether the file could be written successfully or not (false should it be a delta file for memory
+         *         of a different size).
+         */
+        bool saveDeltaToFile(std::string path, SaveToken& since) {
+            DeltaHeader expected;
+            expected.memorySize = size;
+
+            bool empty;
+
+            {
+                std::ifstream existing(path, std::ios::in | std::ios::binary);
+                empty = !existing.is_open() || existing.peek() == std::ifstream::traits_type::eof();
+
+                DeltaHeader header;
+                if(!empty && (!existing.read(reinterpret_cast<char*>(&header), sizeof(header)) || header != expected))
+                    return false;
+            }
+
+            std::ofstream file;
+
+            file.open(path,
+                      std::ios::out | // Output/write mode.
+                      std::ios::binary | // Binary mode.
+                      std::ios::app); // Append to any existing versions.
+
+            if(!file.is_open()) return false;
+
+            if(empty) file.write(reinterpret_cast<const char*>(&expected), sizeof(expected));
+
+            std::vector<u32> pages;
+            for(u32 page = 0; page < getPageCount(); page++)
+                if(empty || isPageModified(page, since)) pages.push_back(page);
+
+            u32 pageCount = static_cast<u32>(pages.size());
+            file.write(reinterpret_cast<const char*>(&pageCount), sizeof(pageCount));
+
+            for(u32 page : pages) {
+                file.write(reinterpret_cast<const char*>(&page), sizeof(page));
+                file.write(reinterpret_cast<const char*>(mem + getPageStart(page)),
+                           static_cast<std::streamsize>(getPageLength(page) * sizeof(Value)));
+            }
+
+            file.close();
+            if(!file) return false;
+
+            since = recordSave();
+            return true;
+        }
+
+        /**
+         * Rebuild the contents of memory as they were when a version was saved to a delta file by
+         * Memory::saveDeltaToFile. Read-only data and regions attached to devices are left unmodified.
+         *
+         * @param path The path of the delta file.
+         * @param since Replaced by the token to pass when next saving to the file should the version be loaded. Unless
+         *        the latest version was loaded, memory differs from the latest version so the token is
+         *        INITIAL_SAVE_TOKEN (meaning every page is saved again).
+         * @param version The version to load (0 being the first saved) or LATEST_VERSION for the most recent.
+         * @return Whether the version could be loaded (memory is unmodified should it not).
+         */
+        bool loadDeltaFromFile(std::string path, SaveToken& since, u32 version = LATEST_VERSION) {
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+
+            DeltaHeader expected;
+            expected.memorySize = size;
+
+            DeltaHeader header;
+            if(!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header != expected) return false;
+
+            std::streampos versionsStart = file.tellg();
+            u32 versionCount = 0;
+            u32 pageCount;
+
+            // Count the versions in the file by skipping over each of them:
+            while(file.read(reinterpret_cast<char*>(&pageCount), sizeof(pageCount))) {
+                for(u32 i = 0; i < pageCount; i++) {
+                    u32 page;
+                    if(!file.read(reinterpret_cast<char*>(&page), sizeof(page)) || page >= getPageCount()) return false;
+                    file.seekg(static_cast<std::streamoff>(getPageLength(page) * sizeof(Value)), std::ios::cur);
+                }
+
+                if(!file) return false;
+                versionCount++;
+            }
+
+            if(versionCount == 0 || (version != LATEST_VERSION && version >= versionCount)) return false;
+            u32 lastVersion = std::min(version, versionCount - 1);
+
+            file.clear();
+            file.seekg(versionsStart);
+
+            for(u32 current = 0; current <= lastVersion; current++) {
+                file.read(reinterpret_cast<char*>(&pageCount), sizeof(pageCount));
+
+                for(u32 i = 0; i < pageCount; i++) {
+                    u32 page;
+                    file.read(reinterpret_cast<char*>(&page), sizeof(page));
+
+                    Address start = getPageStart(page), length = getPageLength(page);
+                    std::streampos pageStart = file.tellg();
+
+                    forEachWritableRange(start, start + length - 1, [&](Address rangeStart, Address amount) {
+                        prepareWrite(rangeStart, amount);
+
+                        file.seekg(pageStart + static_cast<std::streamoff>((rangeStart - start) * sizeof(Value)));
+                        file.read(reinterpret_cast<char*>(mem + rangeStart),
+                                  static_cast<std::streamsize>(amount * sizeof(Value)));
+
+                        touchRegions(rangeStart, amount);
+                    });
+
+                    file.seekg(pageStart + static_cast<std::streamoff>(length * sizeof(Value)));
+                }
+            }
+
+            // Memory is only unmodified relative to the file should the latest version have been loaded. Pages written
+            // by loading remain modified relative to any other file:
+            since = lastVersion == versionCount - 1 ? recordSave() : INITIAL_SAVE_TOKEN;
+            return true;
+        }
+
+        /**
+         * Returns whether any value within a page (of PAGE_SIZE values) has been modified since the save (or load)
+         * identified by a token (see Memory::saveDeltaToFile).
+         */
+        bool isPageModified(Address page, SaveToken since) const {
+            return dirtyPages[page] != 0 || pageSaves[page] >= since;
+        }
+
+        /**
+         * Returns whether any of the given range of addresses lie within read-only data.
+         */
+        bool overlapsReadOnly(Address firstAddress, Address lastAddress) const {
+            for(const auto& range : readOnlyRanges)
+                if(range.first <= lastAddress && range.second >= firstAddress) return true;
+
+            return false;
+        }
+
+        /**
+         * Fetch the write generation of a range of memory. Memory is divided into small regions, each with a generation
+         * that is incremented every time a value within that region is modified. The generation of a range is the sum
+         * of the generations of the regions it overlaps, meaning that any data derived from memory contents (such as
+         * decoded instructions) can be checked for staleness by comparing generations rather than the data itself.
+         *
+         * In the wrapped and mirrored access modes, the range is that of the addresses once mapped as they would be by
+         * an access. Should it not map to a single range of memory, the generation of all memory is returned instead
+         * (or 0 should no memory be accessible within the range at all).
+         *
+         * @param firstAddress The first address of the range (must be within bounds in checked access mode).
+         * @param lastAddress The final address of the range (must be within bounds in checked access mode).
+         * @return The current write generation of the range.
+         */
+        u32 getGeneration(Address firstAddress, Address lastAddress) const {
+            u32 generation = 0;
+
+            if(accessMode != CHECKED_ACCESS && !mapRange(firstAddress, lastAddress)) return 0;
+
+            for(Address region = firstAddress >> REGION_SHIFT; region <= lastAddress >> REGION_SHIFT; region++)
+                generation += regionGenerations[region];
+
+            return generation;
+        }
+
+        /**
+         * Fetch the internals of memory through which it may be accessed directly. Addresses below the limit are those
+         * for which a direct access behaves exactly as an access through Memory::read or Memory::write would, provided
+         * that the regions, page and write count are updated on writes. The limit is 0 while any read-only data,
+         * devices or snapshots exist. The pointers remain valid for the lifetime of memory but the limit only until
+         * any of those or the access mode are next changed.
+         */
+        DirectAccess getDirectAccess() {
+            Address limit = size;
+
+            if(!readOnlyRanges.empty() || !devices.empty() || !snapshots.empty()) limit = 0;
+            else if(accessMode != CHECKED_ACCESS) {
+                // Addresses are only unaffected by a mask of contiguous low bits should they be below it:
+                if((addressMask & (addressMask + 1)) != 0) limit = 0;
+                else if(addressMask < size) limit = addressMask + 1;
+            }
+
+            return { mem, regionGenerations.data(), dirtyPages.data(), &writeCount, limit };
+        }
+
+        /**
+         * Returns a count that changes whenever the write generation of any region does. Checking it first allows the
+         * cost of Memory::getGeneration to be avoided while nothing has been written to memory.
+         */
+        u32 getWriteCount() const { return writeCount; }
+
+        /**
+         * Returns an identifier unique to this memory. Unlike the address of the memory, identifiers are never reused
+         * should memory be destroyed, so data derived from memory contents may be cached against it safely.
+         */
+        u64 getId() const { return memoryId; }
+
         const Address size;
 
     protected:
+        /**
+         * Copy data from a binary file into emulator memory.
+         *
+         * @param offset The offset in memory to which data should be copied.
+         * @param fileOffset The offset in bytes within the file from which to begin copying.
+         * @param copied Set to the number of values of the file covered, including any skipped (optional).
+         * @return Whether the file could be opened successfully or not.
+         */
+        bool copyFromFile(const std::string& path, Address offset, std::size_t fileOffset, Address* copied = nullptr) {
+            std::ifstream file;
+
+            file.open(path,
+                      std::ios::in | // Input/read mode.
+                      std::ios::binary | // Binary mode.
+                      std::ios::ate); // Place cursor at end of file st that tellg will return file size.
+
+            if(file.is_open() && size > offset) {
+                std::size_t fileSize = static_cast<std::size_t>(file.tellg());
+                std::size_t available = fileSize > fileOffset ? (fileSize - fileOffset) / sizeof(Value) : 0;
+                Address readSize = static_cast<Address>(std::min<std::size_t>(available, size - offset));
+
+                // Read-only data may not be writable by the host and device pages are not accessible, so both are
+                // skipped over:
+                auto copyRange = [&](Address start, Address amount) {
+                    prepareWrite(start, amount);
+
+                    std::size_t byteOffset = fileOffset + static_cast<std::size_t>(start - offset) * sizeof(Value);
+                    file.seekg(static_cast<std::streamoff>(byteOffset), std::ios::beg);
+                    file.read(reinterpret_cast<char*>(mem + start),
+                              static_cast<std::streamsize>(amount * sizeof(Value)));
+
+                    touchRegions(start, amount);
+                };
+
+                if(readSize > 0) forEachWritableRange(offset, offset + readSize - 1, copyRange);
+
+                if(copied) *copied = readSize;
+
+                file.close();
+                return true;
+            }
+
+            return false;
+        }
+
+        /**
+         * Apply the access mode to an address about to be accessed.
+         *
+         * @param address The address, which is replaced by the address of the value to access.
+         * @return Whether the access may go ahead (false should it fault).
+         * @throws OutOfBounds Should the address be out of bounds in checked access mode.
+         */
+        bool mapAddress(Address& address) const {
+            if(accessMode == CHECKED_ACCESS) {
+                assertWithinBounds(address);
+                return true;
+            }
+
+            address &= addressMask;
+            if(address < size) return true;
+
+            if(accessMode == MIRRORED_ACCESS) {
+                address %= size;
+                return true;
+            }
+
+            faultCount++;
+            lastFaultAddress = address;
+            return false;
+        }
+
+        /**
+         * Apply the wrapped or mirrored access mode to a range of addresses (see getGeneration).
+         *
+         * @return False should no memory be accessible within the range at all.
+         */
+        bool mapRange(Address& firstAddress, Address& lastAddress) const {
+            Address length = lastAddress - firstAddress;
+
+            firstAddress &= addressMask;
+            lastAddress &= addressMask;
+
+            if(lastAddress - firstAddress != length) { // Range wraps around the address mask.
+                firstAddress = 0;
+                lastAddress = size - 1;
+            }
+            else if(accessMode == WRAPPED_ACCESS) {
+                if(firstAddress >= size) return false;
+                lastAddress = std::min<Address>(lastAddress, size - 1);
+            }
+            else if(lastAddress >= size) {
+                if(firstAddress / size == lastAddress / size) { // Entirely within a single mirror of memory.
+                    firstAddress %= size;
+                    lastAddress %= size;
+                }
+                else {
+                    firstAddress = 0;
+                    lastAddress = size - 1;
+                }
+            }
+
+            return true;
+        }
+
         /**
          * Checks if the given address is within bounds, throwing an OutOfBounds exception if that is not the case.
          *
@@ -179,7 +875,207 @@ namespace emu {
             if(!withinBounds(address)) throw OutOfBounds(address);
         }
 
+        /**
+         * Increment the write generation of every region overlapping the specified range of addresses. Should be
+         * called whenever memory is modified without going through the write method.
+         */
+        void touchRegions(Address startAddress, Address amount) {
+            if(amount == 0) return;
+
+            for(Address region = startAddress >> REGION_SHIFT; region <= (startAddress + amount - 1) >> REGION_SHIFT;
+                region++)
+                regionGenerations[region]++;
+
+            for(Address page = startAddress >> PAGE_SHIFT; page <= (startAddress + amount - 1) >> PAGE_SHIFT; page++)
+                dirtyPages[page] = 1;
+
+            writeCount++;
+        }
+
+        /**
+         * Copy the page containing the given address into the newest snapshot should it not have been already. Must be
+         * called before any value is modified.
+         */
+        void prepareWrite(Address address) {
+            if(!snapshots.empty() && pageSnapshots[address >> PAGE_SHIFT] != snapshots.back().id)
+                copyPage(address >> PAGE_SHIFT);
+        }
+
+        /**
+         * Copy every page overlapping a range of addresses into the newest snapshot (see the single address overload).
+         */
+        void prepareWrite(Address startAddress, Address amount) {
+            if(snapshots.empty() || amount == 0) return;
+
+            for(Address page = startAddress >> PAGE_SHIFT; page <= (startAddress + amount - 1) >> PAGE_SHIFT; page++)
+                if(pageSnapshots[page] != snapshots.back().id) copyPage(page);
+        }
+
     private:
-        std::unique_ptr<Value[]> mem;
+        /// How accesses to a page are performed.
+        struct PageMapping {
+            Value* read = nullptr; /// Host memory holding the page should it be RAM or ROM.
+            Value* write = nullptr; /// Host memory holding the page should it be RAM (and contain no read-only data).
+            Device* device = nullptr; /// Device handling accesses should the page be neither RAM nor ROM.
+            Address deviceStart = 0; /// First address of the region the device is attached to.
+        };
+
+        struct AttachedDevice {
+            Device* device;
+            Address firstAddress;
+            Address lastAddress;
+        };
+
+        /**
+         * Update the mapping of a page according to the devices attached and read-only data.
+         */
+        void mapPage(Address page) {
+            Address start = getPageStart(page);
+            Address last = start + getPageLength(page) - 1;
+
+            PageMapping& mapping = pageTable[page];
+            mapping = PageMapping();
+
+            for(const auto& attached : devices) {
+                if(attached.firstAddress <= start && attached.lastAddress >= start) {
+                    mapping.device = attached.device;
+                    mapping.deviceStart = attached.firstAddress;
+                    return;
+                }
+            }
+
+            mapping.read = mem + start;
+            if(!overlapsReadOnly(start, last)) mapping.write = mem + start;
+        }
+
+        void mapPages(Address firstAddress, Address lastAddress) {
+            for(Address page = firstAddress >> PAGE_SHIFT; page <= lastAddress >> PAGE_SHIFT; page++) mapPage(page);
+        }
+
+        /**
+         * Call a function with each maximal range of addresses (as its start address and number of values) within the
+         * given range that may be written to in host memory directly, meaning those neither read-only nor attached to a
+         * device.
+         */
+        template <typename Function>
+        void forEachWritableRange(Address firstAddress, Address lastAddress, Function function) const {
+            Address runStart = firstAddress;
+
+            auto endRun = [&](Address runEnd, Address next) { // Run ends just before runEnd.
+                if(runEnd > runStart) function(runStart, runEnd - runStart);
+                runStart = next;
+            };
+
+            for(Address address = firstAddress; address <= lastAddress;) {
+                Address page = address >> PAGE_SHIFT;
+                Address pageEnd = std::min<Address>(getPageStart(page) + getPageLength(page), lastAddress + 1);
+
+                const PageMapping& mapping = pageTable[page];
+
+                if(mapping.device) endRun(address, pageEnd);
+                else if(!mapping.write) { // Page at least partially read-only.
+                    for(; address < pageEnd; address++)
+                        if(isReadOnly(address)) endRun(address, address + 1);
+                }
+
+                address = pageEnd;
+            }
+
+            endRun(lastAddress + 1, lastAddress + 1);
+        }
+
+        /// Header at the start of files written by Memory::saveDeltaToFile.
+        struct DeltaHeader {
+            char magic[4] = { 'W', '8', '6', 'D' };
+            u32 valueSize = sizeof(Value);
+            u32 pageShift = PAGE_SHIFT;
+            u32 memorySize = 0;
+
+            bool operator!=(const DeltaHeader& other) const {
+                return std::string(magic, 4) != std::string(other.magic, 4) || valueSize != other.valueSize ||
+                       pageShift != other.pageShift || memorySize != other.memorySize;
+            }
+        };
+
+        Address getPageCount() const { return (size + PAGE_SIZE - 1) >> PAGE_SHIFT; }
+        Address getPageStart(Address page) const { return page << PAGE_SHIFT; }
+        Address getPageLength(Address page) const { return std::min<Address>(PAGE_SIZE, size - getPageStart(page)); }
+
+        /// Copies of pages taken when they were first written to after a snapshot was taken.
+        struct Snapshot {
+            SnapshotId id;
+            std::unordered_map<Address, std::vector<Value>> pages; /// Copied values indexed by page number.
+        };
+
+        void copyPage(Address page) {
+            Address start = getPageStart(page);
+
+            snapshots.back().pages.try_emplace(page, mem + start, mem + start + getPageLength(page));
+            pageSnapshots[page] = snapshots.back().id;
+        }
+
+        void restorePage(Address page, const std::vector<Value>& values) {
+            Address start = getPageStart(page);
+
+            // Read-only data may not be writable by the host (and never changes) and data behind devices is
+            // inaccessible, so only the remainder of the page is restored. Ranges left unchanged are not touched so
+            // that data derived from them (such as decoded instructions) remains valid:
+            forEachWritableRange(start, start + getPageLength(page) - 1, [&](Address rangeStart, Address amount) {
+                auto first = values.begin() + (rangeStart - start);
+                if(std::equal(first, first + amount, mem + rangeStart)) return;
+
+                std::copy(first, first + amount, mem + rangeStart);
+                touchRegions(rangeStart, amount);
+            });
+        }
+
+        typename std::vector<Snapshot>::iterator findSnapshot(SnapshotId id) {
+            return std::find_if(snapshots.begin(), snapshots.end(),
+                                [id](const Snapshot& snapshot) { return snapshot.id == id; });
+        }
+
+        inline static std::atomic<u64> nextId { 1 };
+        const u64 memoryId = nextId++;
+
+        HostMemory storage;
+        Value* mem; /// Values held in storage.
+        std::vector<u32> regionGenerations;
+        u32 writeCount = 0;
+
+        /// First and last addresses of read-only data (ordered by first address).
+        std::vector<std::pair<Address, Address>> readOnlyRanges;
+
+        AccessMode accessMode = CHECKED_ACCESS;
+        Address addressMask = ~Address(0);
+
+        std::vector<Snapshot> snapshots; /// Ordered from oldest to newest.
+        std::vector<SnapshotId> pageSnapshots; /// Newest snapshot into which each page has been copied.
+        SnapshotId lastSnapshotId = 0;
+
+        /**
+         * Records that memory has been saved to (or loaded from) a delta file, returning the token identifying this
+         * point. Pages modified since the previous save are only flagged by dirtyPages (so that translated code need
+         * only set a flag when writing) until this moves them into pageSaves.
+         */
+        SaveToken recordSave() {
+            for(Address page = 0; page < getPageCount(); page++) {
+                if(dirtyPages[page]) {
+                    pageSaves[page] = saveCount;
+                    dirtyPages[page] = 0;
+                }
+            }
+
+            return ++saveCount;
+        }
+
+        std::vector<u8> dirtyPages; /// Whether each page has been modified since memory was last saved or loaded.
+        std::vector<SaveToken> pageSaves; /// Number of saves preceding the latest modification of each page.
+        SaveToken saveCount = 0; /// Number of times memory has been saved (or loaded), so the latest save token.
+
+        std::vector<PageMapping> pageTable;
+        std::vector<AttachedDevice> devices;
+
+        mutable u32 faultCount = 0; /// Mutable as reads may fault too.
+        mutable Address lastFaultAddress = 0;
     };
 }
\ No newline at end of file
@@ -9,6 +9,9 @@ namespace emu {
     /// unsigned integer is used instead.
     using AbsAddr = u32;
 
+    /// Mask applied to absolute addresses as the 8086 has only 20 address lines (so addresses wrap at 1 MiB).
+    constexpr AbsAddr ABSOLUTE_ADDRESS_MASK = 0xFFFFF;
+
     /// Values stored in memory are 8-bit wide.
     using MemValue = u8;
 
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "catch.hpp"
+#include "emu/cpu/intel8086.hpp"
+
+/*
+ * Utilities shared by tests that execute the same program by two different means (such as the handlers and the
+ * reference instruction objects, or translated code and the interpreter) and compare the resulting CPU states.
+ */
+namespace test {
+    /**
+     * Set every general-purpose register to a distinct value with a mix of set and clear bits, and the stack segment to
+     * 0 such that the stack lies within the first 256 bytes of memory.
+     */
+    inline void initialiseRegisters(emu::cpu::Intel8086& cpu) {
+        using namespace emu::cpu;
+
+        cpu.generalRegisters.set(reg::AX_REGISTER, 0x1234);
+        cpu.generalRegisters.set(reg::BX_REGISTER, 0xF0F0);
+        cpu.generalRegisters.set(reg::CX_REGISTER, 0x80A0);
+        cpu.generalRegisters.set(reg::DX_REGISTER, 0x7F01);
+        cpu.generalRegisters.set(reg::SOURCE_INDEX, 0x0080);
+        cpu.generalRegisters.set(reg::DESTINATION_INDEX, 0x8000);
+        cpu.generalRegisters.set(reg::BASE_POINTER, 0x0001);
+        cpu.generalRegisters.set(reg::STACK_POINTER, 0x00AA);
+        cpu.segmentRegisters.set(reg::STACK_SEGMENT, 0);
+    }
+
+    /**
+     * Require that two CPUs have identical general-purpose registers, status flags and instruction pointers.
+     */
+    inline void requireSameState(const emu::cpu::Intel8086& cpu, const emu::cpu::Intel8086& other) {
+        using namespace emu::cpu;
+
+        for(auto index : { reg::AX_REGISTER, reg::BX_REGISTER, reg::CX_REGISTER, reg::DX_REGISTER, reg::STACK_POINTER,
+                           reg::BASE_POINTER, reg::SOURCE_INDEX, reg::DESTINATION_INDEX })
+            REQUIRE(cpu.generalRegisters.get(index) == other.generalRegisters.get(index));
+
+        for(auto flag : { reg::CARRY_FLAG, reg::PARITY_FLAG, reg::AUX_CARRY_FLAG, reg::ZERO_FLAG, reg::SIGN_FLAG,
+                          reg::OVERFLOW_FLAG })
+            REQUIRE(cpu.getFlag(flag) == other.getFlag(flag));
+
+        REQUIRE(cpu.getRelativeInstructionPointer() == other.getRelativeInstructionPointer());
+    }
+
+    /**
+     * Execute the instruction at CS:IP using its reference instruction object (see DecodedInstruction::toInstruction).
+     */
+    inline void executeReferenceInstruction(emu::cpu::Intel8086& cpu, emu::Mem& memory) {
+        auto instruction = cpu.fetchDecodeInstruction(cpu.getAbsoluteInstructionPointer(), memory);
+        REQUIRE(instruction);
+        REQUIRE(cpu.executeInstruction(*instruction->toInstruction(), memory));
+    }
+}
@@ -1,11 +1,12 @@
 #include "executor.hpp"
 
 #include "logging.hpp"
+#include "emu/cpu/jit/translator.hpp"
 
 namespace cli {
     Executor::Executor(emu::AbsAddr memorySize, std::string path, const assembly::Style& style)
     : memory(memorySize), asmStyle(style) {
-        memory.loadFromFile(path);
+        memory.mapFromFile(path);
     }
 
     bool Executor::runCycle() {
@@ -17,7 +18,7 @@ namespace cli {
             logging::success("Instruction fetched and decoded successfully: " + instruction->toAssembly(cpu, asmStyle));
             logging::info("Instruction raw data: " + instruction->getRawDataString());
 
-            bool success = cpu.executeInstruction(instruction, memory);
+            bool success = cpu.executeInstruction(*instruction, memory);
 
             if(success) logging::success("Instruction executed successfully!");
             else logging::error("Instruction failed to execute successfully.");
@@ -51,4 +52,54 @@ namespace cli {
         logging::info("--- ALL " + std::to_string(count) + " CYCLES COMPLETED ---");
         return count;
     }
+
+    unsigned int Executor::runBlocks(unsigned int count) {
+        auto result = cpu.run(memory, count);
+        auto executed = static_cast<unsigned int>(result.instructionsRetired);
+
+        switch(result.reason) {
+        case emu::cpu::DECODE_FAILURE_STOP:
+        case emu::cpu::EXECUTION_FAILURE_STOP:
+            logging::error("Block failed to execute successfully at address: " +
+                           convert::toHexString(cpu.getAbsoluteInstructionPointer()) + " - halting...");
+            cpu.halted = true;
+            break;
+
+        case emu::cpu::BREAKPOINT_STOP:
+            logging::info("Breakpoint reached at address: " + convert::toHexString(cpu.getAbsoluteInstructionPointer()));
+            break;
+
+        default: break;
+        }
+
+        logging::info("--- " + std::to_string(executed) + " OF " + std::to_string(count) + " INSTRUCTIONS EXECUTED ---");
+        return executed;
+    }
+
+    bool Executor::enableJit() {
+        return cpu.setJitEnabled(true);
+    }
+
+    void Executor::enableWrappedAccess() {
+        memory.setAccessMode(emu::Mem::WRAPPED_ACCESS, emu::ABSOLUTE_ADDRESS_MASK);
+    }
+
+    void Executor::logCacheStatistics() const {
+        const auto& decodeCache = cpu.getDecodeCache();
+        const auto& blockCache = cpu.getBlockCache();
+
+        logging::info("Decode cache hits: " + std::to_string(decodeCache.getHits()) +
+                      ", misses: " + std::to_string(decodeCache.getMisses()));
+        logging::info("Block cache hits: " + std::to_string(blockCache.getHits()) +
+                      ", misses: " + std::to_string(blockCache.getMisses()));
+        logging::info("Fused instruction pairs executed: " + std::to_string(cpu.getFusedPairExecutions()));
+
+        if(memory.getFaultCount() > 0)
+            logging::warning("Memory accesses beyond the end of memory: " + std::to_string(memory.getFaultCount()) +
+                             ", last at address: " + convert::toHexString(memory.getLastFaultAddress()));
+
+        if(const auto* translator = cpu.getTranslator())
+            logging::info("Blocks translated: " + std::to_string(translator->getTranslationCount()) +
+                          ", native executions: " + std::to_string(translator->getNativeExecutionCount()));
+    }
 }
\ No newline at end of file
@@ -1,6 +1,17 @@
+#include <optional>
 #include "logging.hpp"
 #include "executor.hpp"
 
+namespace {
+    constexpr unsigned int DEFAULT_CYCLE_COUNT = 25; /// Each cycle is logged so only a few are run by default.
+    constexpr unsigned int DEFAULT_INSTRUCTION_COUNT = 1000000; /// Enough for hot blocks to be translated many times over.
+
+    void logUsage() {
+        logging::error("Please execute with appropriate arguments: "
+                       "WiredSound <memory size> <path> [--blocks | --jit] [--wrap] [--count <n>]");
+    }
+}
+
 int main(int argc, char* argv[]) {
     if(argc >= 3) {
         auto memorySize = convert::fromHexString<emu::AbsAddr>(argv[1]);
@@ -11,12 +22,45 @@ int main(int argc, char* argv[]) {
             asmStyle.numericalRepresentation = assembly::HEX_REPRESENTATION;
             asmStyle.numericalStyle = assembly::WITH_PREFIX;
 
+            std::string mode;
+            bool wrap = false;
+            std::optional<unsigned int> count;
+
+            for(int i = 3; i < argc; i++) {
+                std::string option = argv[i];
+
+                if(option == "--wrap") wrap = true;
+                else if(option == "--blocks" || option == "--jit") mode = option;
+                else if(option == "--count" && i + 1 < argc) {
+                    count = convert::fromString<unsigned int>(argv[++i]);
+
+                    if(!count) {
+                        logging::error("Invalid run count given! Please express the count in decimal format.");
+                        return 0;
+                    }
+                }
+                else {
+                    logging::error("Unrecognised or incomplete option: " + option);
+                    logUsage();
+                    return 0;
+                }
+            }
+
             cli::Executor exec(*memorySize, path, asmStyle);
-            exec.runCycles(25);
+
+            if(wrap) exec.enableWrappedAccess();
+
+            if(mode == "--jit" && !exec.enableJit())
+                logging::warning("Translation into native code is not supported on this platform.");
+
+            if(mode == "--blocks" || mode == "--jit") exec.runBlocks(count.value_or(DEFAULT_INSTRUCTION_COUNT));
+            else exec.runCycles(count.value_or(DEFAULT_CYCLE_COUNT));
+
+            exec.logCacheStatistics();
         }
         else logging::error("Invalid memory size given! Please express the memory size in hexadecimal format.");
     }
-    else logging::error("Please execute with appropriate arguments: WiredSound <memory size> <path>");
+    else logUsage();
 
     return 0;
 }
\ No newline at end of file
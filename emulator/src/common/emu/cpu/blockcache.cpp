@@ -0,0 +1,58 @@
+#include "emu/cpu/blockcache.hpp"
+
+namespace emu::cpu {
+    const BasicBlock* BlockCache::lookup(u16 codeSegment, OffsetAddr instructionPointer, const Mem& memory) {
+        const Entry& entry = entries[getIndex(codeSegment, instructionPointer)];
+
+        if(entry.valid && entry.block.codeSegment == codeSegment &&
+           entry.block.instructionPointer == instructionPointer && entry.memoryId == memory.getId() &&
+           !isStale(entry.block, memory)) {
+            hits++;
+            return &entry.block;
+        }
+
+        misses++;
+        return nullptr;
+    }
+
+    BasicBlock& BlockCache::allocate(u16 codeSegment, OffsetAddr instructionPointer) {
+        Entry& entry = entries[getIndex(codeSegment, instructionPointer)];
+
+        entry.valid = false;
+        entry.block.codeSegment = codeSegment;
+        entry.block.instructionPointer = instructionPointer;
+        entry.block.count = 0;
+
+        return entry.block;
+    }
+
+    void BlockCache::commit(BasicBlock& block, const Mem& memory) {
+        Entry& entry = entries[getIndex(block.codeSegment, block.instructionPointer)];
+
+        entry.memoryId = memory.getId();
+        entry.generation = memory.getGeneration(block.firstAddress, block.lastAddress);
+        entry.valid = true;
+    }
+
+    bool BlockCache::isStale(const BasicBlock& block, const Mem& memory) const {
+        const Entry& entry = entries[getIndex(block.codeSegment, block.instructionPointer)];
+
+        return entry.generation != memory.getGeneration(block.firstAddress, block.lastAddress);
+    }
+
+    void BlockCache::clear() {
+        for(Entry& entry : entries) entry.valid = false;
+    }
+
+    unsigned long BlockCache::getHits() const {
+        return hits;
+    }
+
+    unsigned long BlockCache::getMisses() const {
+        return misses;
+    }
+
+    std::size_t BlockCache::getIndex(u16 codeSegment, OffsetAddr instructionPointer) {
+        return (instructionPointer ^ (codeSegment << 4)) & (ENTRY_COUNT - 1);
+    }
+}
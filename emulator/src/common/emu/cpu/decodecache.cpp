@@ -0,0 +1,42 @@
+#include "emu/cpu/decodecache.hpp"
+
+namespace emu::cpu {
+    const instr::DecodedInstruction* DecodeCache::lookup(AbsAddr address, const Mem& memory) {
+        const Entry& entry = entries[address & (ENTRY_COUNT - 1)];
+
+        if(entry.valid && entry.address == address && entry.memoryId == memory.getId() &&
+           entry.generation == memory.getGeneration(address, entry.lastAddress)) {
+            hits++;
+            return &entry.instruction;
+        }
+
+        misses++;
+        return nullptr;
+    }
+
+    void DecodeCache::insert(AbsAddr address, const Mem& memory, const instr::DecodedInstruction& instruction) {
+        Entry& entry = entries[address & (ENTRY_COUNT - 1)];
+
+        AbsAddr lastAddress = address + instruction.length - 1;
+        if(!memory.withinBounds(lastAddress)) lastAddress = address;
+
+        entry.address = address;
+        entry.lastAddress = lastAddress;
+        entry.memoryId = memory.getId();
+        entry.generation = memory.getGeneration(address, lastAddress);
+        entry.valid = true;
+        entry.instruction = instruction;
+    }
+
+    void DecodeCache::clear() {
+        for(Entry& entry : entries) entry.valid = false;
+    }
+
+    unsigned long DecodeCache::getHits() const {
+        return hits;
+    }
+
+    unsigned long DecodeCache::getMisses() const {
+        return misses;
+    }
+}
@@ -1,35 +1,22 @@
 #include "emu/cpu/instr/argument.hpp"
 
+#include <type_traits>
 #include "convert.hpp"
+#include "emu/cpu/instr/effectiveaddress.hpp"
 
 namespace emu::cpu::instr {
     /*
      * DataArgument implementation:
      */
 
-    DataArgument::DataArgument(std::vector<u8> raw) : rawData(raw) {
-        if(rawData.empty()) rawData.push_back(0u); // Require the vector to have at least 1 element.
-        if(rawData.size() > 2) rawData.resize(2); // Ensure vector has no more than 2 elements.
-    }
-
-    const std::vector<u8>& DataArgument::getRawData() const {
-        return rawData;
-    }
-
-    u16 DataArgument::getValueUsingDataSize(DataSize size) const {
-        if(size == WORD_DATA_SIZE) return getWordValue();
-        else return static_cast<u16>(getByteValue());
-    }
-
-    u8 DataArgument::getByteValue() const {
-        return rawData[0];
-    }
+    static_assert(std::is_trivially_copyable_v<Displacement> && std::is_trivially_copyable_v<Immediate>,
+                  "Data arguments must be trivially copyable so that they never require heap allocation.");
 
-    u16 DataArgument::getWordValue() const {
-        u8 low = rawData[0];
-        u8 high = rawData.size() > 1 ? rawData[1] : 0; // Get rawData[1] if present. Otherwise, assume high byte is 0.
+    DataArgument::DataArgument(const std::vector<u8>& raw)
+    : DataArgument(raw.size() > 1 ? DataArgument(raw[0], raw[1]) : DataArgument(raw.empty() ? 0 : raw[0])) {}
 
-        return convert::createWordFromBytes(low, high);
+    std::vector<u8> DataArgument::getRawData() const {
+        return std::vector<u8>(rawData, rawData + rawSize);
     }
 
     /*
@@ -49,6 +36,9 @@ namespace emu::cpu::instr {
 
     std::string Displacement::toAssembly(DataSize, const ModRegRm& modRegRm,
                                          const reg::GeneralRegisters& registers, const assembly::Style& style) const {
+        if(effectiveaddress::isDirectAddress(modRegRm.getAddressingMode(), modRegRm.getDisplacementType()))
+            return style.displacementBegin + convert::numberToAssembly(getWordValue(), style) + style.displacementEnd;
+
         std::string offsetString;
 
         switch(modRegRm.getDisplacementType()) {
@@ -98,53 +88,11 @@ namespace emu::cpu::instr {
         return style.displacementBegin + offsetString + style.displacementEnd;
     }
 
-    u16 Displacement::getValueUsingAddressingMode(AddressingMode mode) const {
-        switch(mode) {
-        case BYTE_DISPLACEMENT:
-            return static_cast<u16>(getByteValue());
-
-        case WORD_DISPLACEMENT:
-            return getWordValue();
-
-        default: return 0; // Invalid addressing mode so just return 0.
-        }
-    }
-
-    AbsAddr Displacement::resolve(AddressingMode mode, DisplacementType type, reg::GeneralRegisters& registers) const {
-        u16 displacementValue = getValueUsingAddressingMode(mode);
-
-        switch(type) {
-        case BX_SI_DISPLACEMENT:
-            return registers.get(reg::BX_REGISTER) +
-                   registers.get(reg::SOURCE_INDEX) +
-                   displacementValue;
-
-        case BX_DI_DISPLACEMENT:
-            return registers.get(reg::BX_REGISTER) +
-                   registers.get(reg::DESTINATION_INDEX) +
-                   displacementValue;
-
-        case BP_SI_DISPLACEMENT:
-            return registers.get(reg::BASE_POINTER) +
-                   registers.get(reg::SOURCE_INDEX) +
-                   displacementValue;
-
-        case BP_DI_DISPLACEMENT:
-            return registers.get(reg::BASE_POINTER) +
-                   registers.get(reg::DESTINATION_INDEX) +
-                   displacementValue;
+    OffsetAddr Displacement::resolve(AddressingMode mode, DisplacementType type,
+                                     const reg::GeneralRegisters& registers) const {
+        // Kernels of modes without a displacement only use the value should it be a direct address:
+        u16 displacementValue = mode == BYTE_DISPLACEMENT ? getSignExtendedValue() : getWordValue();
 
-        case SI_DISPLACEMENT:
-            return registers.get(reg::SOURCE_INDEX) + displacementValue;
-
-        case DI_DISPLACEMENT:
-            return registers.get(reg::DESTINATION_INDEX) + displacementValue;
-
-        case BP_DISPLACEMENT:
-            return registers.get(reg::BASE_POINTER) + displacementValue;
-
-        default: // BX_DISPLACEMENT
-            return registers.get(reg::BX_REGISTER) + displacementValue;
-        }
+        return EFFECTIVE_ADDRESS_MODES[mode * 8 + type].kernel(registers, displacementValue);
     }
 }
\ No newline at end of file
@@ -1,11 +1,49 @@
 #include "emu/cpu/instr/arithmeticlogic.hpp"
 
+#include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/instr/handler.hpp"
+
 namespace emu::cpu::instr {
-    AddEG::AddEG(Opcode instrOpcode, ModRegRm instrModRegRm,
-                 std::optional<Displacement> displacement, std::optional<Immediate> immediate)
-    : ComplexInstructionEG("add", instrOpcode, instrModRegRm, displacement, immediate) {}
+    namespace {
+        template <AluFunction Function>
+        u16 performSizedOperation(Intel8086& cpu, DataSize size, u16 dest, u16 src) {
+            u16 result = size == WORD_DATA_SIZE ? handlers::aluOperation<Function, u16>(cpu, dest, src)
+                                                : handlers::aluOperation<Function, u8>(cpu, static_cast<u8>(dest),
+                                                                                       static_cast<u8>(src));
+
+            return writesResult(Function) ? result : dest;
+        }
+    }
+
+    /*
+     * ArithmeticLogicEG implementation:
+     */
 
-    u16 AddEG::performOperation(u16 dest, u16 src) {
-        return dest + src;
+    ArithmeticLogicEG::ArithmeticLogicEG(AluFunction aluFunction, Opcode instrOpcode, ModRegRm instrModRegRm,
+                                         std::optional<Displacement> displacement, std::optional<Immediate> immediate)
+    : ComplexInstructionEG(getAluFunctionIdentifier(aluFunction), instrOpcode, instrModRegRm, displacement, immediate),
+      function(aluFunction) {}
+
+    u16 ArithmeticLogicEG::performOperation(Intel8086& cpu, DataSize size, u16 dest, u16 src) {
+        switch(function) {
+        case ADD_FUNCTION: return performSizedOperation<ADD_FUNCTION>(cpu, size, dest, src);
+        case OR_FUNCTION: return performSizedOperation<OR_FUNCTION>(cpu, size, dest, src);
+        case ADC_FUNCTION: return performSizedOperation<ADC_FUNCTION>(cpu, size, dest, src);
+        case SBB_FUNCTION: return performSizedOperation<SBB_FUNCTION>(cpu, size, dest, src);
+        case AND_FUNCTION: return performSizedOperation<AND_FUNCTION>(cpu, size, dest, src);
+        case SUB_FUNCTION: return performSizedOperation<SUB_FUNCTION>(cpu, size, dest, src);
+        case XOR_FUNCTION: return performSizedOperation<XOR_FUNCTION>(cpu, size, dest, src);
+        case CMP_FUNCTION: return performSizedOperation<CMP_FUNCTION>(cpu, size, dest, src);
+        }
+
+        return dest;
     }
-}
\ No newline at end of file
+
+    /*
+     * AddEG implementation:
+     */
+
+    AddEG::AddEG(Opcode instrOpcode, ModRegRm instrModRegRm,
+                 std::optional<Displacement> displacement, std::optional<Immediate> immediate)
+    : ArithmeticLogicEG(ADD_FUNCTION, instrOpcode, instrModRegRm, displacement, immediate) {}
+}
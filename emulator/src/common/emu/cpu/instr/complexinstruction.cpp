@@ -1,16 +1,30 @@
 #include "emu/cpu/instr/complexinstruction.hpp"
 
 #include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/instr/handler.hpp"
 #include "logging.hpp"
 
 namespace emu::cpu::instr {
+    namespace {
+        /// The size of an instruction with a MOD-REG-R/M byte and the given displacement and immediate values.
+        OffsetAddr calculateRawSize(const std::optional<Displacement>& displacement,
+                                    const std::optional<Immediate>& immediate) {
+            unsigned int size = 2; // Opcode and MOD-REG-R/M byte.
+
+            if(displacement) size += displacement->getSize();
+            if(immediate) size += immediate->getSize();
+
+            return static_cast<OffsetAddr>(size);
+        }
+    }
+
     /*
      * ComplexInstruction implementation:
      */
 
-    ComplexInstruction::ComplexInstruction(std::string instrIdentifier, Opcode instrOpcode, ModRegRm instrModRegRm,
+    ComplexInstruction::ComplexInstruction(const char* instrIdentifier, Opcode instrOpcode, ModRegRm instrModRegRm,
                                            std::optional<Displacement> displacement, std::optional<Immediate> immediate)
-    : Instruction(instrIdentifier, instrOpcode), modRegRm(instrModRegRm),
+    : Instruction(instrIdentifier, instrOpcode, calculateRawSize(displacement, immediate)), modRegRm(instrModRegRm),
       displacementValue(displacement), immediateValue(immediate) {}
 
     OffsetAddr ComplexInstruction::execute(Intel8086& cpu, Mem& memory) {
@@ -45,7 +59,7 @@ namespace emu::cpu::instr {
             argumentsStr = argumentsToAssemblyDisplacement(cpu, style); break;
         }
 
-        return identifier + " " + argumentsStr;
+        return std::string(identifier) + " " + argumentsStr;
     }
 
     std::vector<u8> ComplexInstruction::getRawData() const {
@@ -79,6 +93,9 @@ namespace emu::cpu::instr {
 
     std::string ComplexInstructionEG::argumentsToAssemblyNoDisplacement(const Intel8086& cpu,
                                                                         const assembly::Style& style) const {
+        if(displacementValue) // Direct address.
+            return argumentsToAssemblySpecifiedDisplacement(cpu, style, *displacementValue);
+
         Displacement zeroDisplacement({ 0 });
         return argumentsToAssemblySpecifiedDisplacement(cpu, style, zeroDisplacement);
     }
@@ -134,12 +151,56 @@ namespace emu::cpu::instr {
 
         switch(opcode.getDirection()) {
         case REG_IS_SOURCE:
-            result = performOperation(rmRegisterValue, regRegisterValue);
+            result = performOperation(cpu, size, rmRegisterValue, regRegisterValue);
             cpu.generalRegisters.set(rmIndex, rmPart, result);
             break;
 
         case REG_IS_DESTINATION:
-            result = performOperation(regRegisterValue, rmRegisterValue);
+            result = performOperation(cpu, size, regRegisterValue, rmRegisterValue);
+            cpu.generalRegisters.set(regIndex, regPart, result);
+            break;
+        }
+    }
+
+    void ComplexInstructionEG::executeNoDisplacement(Intel8086& cpu, Mem& memory) {
+        executeMemoryAddressingMode(cpu, memory);
+    }
+
+    void ComplexInstructionEG::executeByteDisplacement(Intel8086& cpu, Mem& memory) {
+        executeMemoryAddressingMode(cpu, memory);
+    }
+
+    void ComplexInstructionEG::executeWordDisplacement(Intel8086& cpu, Mem& memory) {
+        executeMemoryAddressingMode(cpu, memory);
+    }
+
+    void ComplexInstructionEG::executeMemoryAddressingMode(Intel8086& cpu, Mem& memory) {
+        DataSize size = opcode.getDataSize();
+        AddressingMode mode = modRegRm.getAddressingMode();
+        reg::SegmentRegister segment = getEffectiveAddressMode(modRegRm.value).defaultSegment;
+
+        Displacement displacement = displacementValue ? *displacementValue : Displacement(0);
+        OffsetAddr offset = displacement.resolve(mode, modRegRm.getDisplacementType(), cpu.generalRegisters);
+
+        auto regIndex = modRegRm.getRegisterIndexFromReg(size);
+        auto regPart = modRegRm.getRegisterPartFromReg(size);
+        u16 regRegisterValue = cpu.generalRegisters.get(regIndex, regPart);
+
+        u16 memoryValue = size == WORD_DATA_SIZE ? handlers::readOperand<u16>(cpu, memory, segment, offset)
+                                                 : handlers::readOperand<u8>(cpu, memory, segment, offset);
+
+        u16 result;
+
+        switch(opcode.getDirection()) {
+        case REG_IS_SOURCE:
+            result = performOperation(cpu, size, memoryValue, regRegisterValue);
+
+            if(size == WORD_DATA_SIZE) handlers::writeOperand<u16>(cpu, memory, segment, offset, result);
+            else handlers::writeOperand<u8>(cpu, memory, segment, offset, static_cast<u8>(result));
+            break;
+
+        case REG_IS_DESTINATION:
+            result = performOperation(cpu, size, regRegisterValue, memoryValue);
             cpu.generalRegisters.set(regIndex, regPart, result);
             break;
         }
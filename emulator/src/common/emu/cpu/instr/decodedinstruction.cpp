@@ -0,0 +1,99 @@
+#include "emu/cpu/instr/decodedinstruction.hpp"
+
+#include <functional>
+#include <type_traits>
+#include "convert.hpp"
+#include "emu/cpu/instr/handler.hpp"
+#include "emu/cpu/instr/stack.hpp"
+#include "emu/cpu/instr/flags.hpp"
+#include "emu/cpu/instr/arithmeticlogic.hpp"
+
+namespace emu::cpu::instr {
+    static_assert(std::is_trivially_copyable_v<DecodedInstruction>,
+                  "Decoded instructions must be trivially copyable so that they can be cached without allocation.");
+
+    namespace {
+        /**
+         * Construct the Instruction object equivalent to a decoded instruction and pass it to the given function as its
+         * concrete type, such that calls made on it by the function need not be virtual.
+         *
+         * @return The value returned by the function, or the fallback value should the handler be invalid.
+         */
+        template <typename Result, typename Function>
+        Result withInstruction(const DecodedInstruction& decoded, Result fallback, Function function) {
+            Opcode instrOpcode(decoded.opcode);
+
+            std::optional<Displacement> displacementValue;
+            if(decoded.displacementSize == 1)
+                displacementValue = Displacement(convert::getLeastSigByte(decoded.displacement));
+            if(decoded.displacementSize == 2)
+                displacementValue = Displacement(convert::getLeastSigByte(decoded.displacement),
+                                                 convert::getMostSigByte(decoded.displacement));
+
+            if(isEGHandler(decoded.handler)) {
+                return function(ArithmeticLogicEG(getEncodedAluFunction(decoded.opcode), instrOpcode,
+                                                  ModRegRm(decoded.modRegRm), displacementValue));
+            }
+
+            switch(decoded.handler) {
+            case PUSH_REGISTER_HANDLER:
+                return function(PushTakingRegister(instrOpcode, getEncodedWordRegister(decoded.opcode)));
+
+            case POP_REGISTER_HANDLER:
+                return function(PopTakingRegister(instrOpcode, getEncodedWordRegister(decoded.opcode)));
+
+            case HALT_HANDLER:
+                return function(HaltInstruction(instrOpcode));
+
+            case PUSH_FLAGS_HANDLER:
+                return function(PushFlags(instrOpcode));
+
+            case POP_FLAGS_HANDLER:
+                return function(PopFlags(instrOpcode));
+
+            case LOAD_AH_FROM_FLAGS_HANDLER:
+                return function(LoadAhFromFlags(instrOpcode));
+
+            case STORE_AH_INTO_FLAGS_HANDLER:
+                return function(StoreAhIntoFlags(instrOpcode));
+
+            default: return fallback;
+            }
+        }
+    }
+
+    std::unique_ptr<Instruction> DecodedInstruction::toInstruction() const {
+        auto allocate = [](auto instruction) -> std::unique_ptr<Instruction> {
+            return std::make_unique<decltype(instruction)>(instruction);
+        };
+
+        return withInstruction(*this, std::unique_ptr<Instruction>(), allocate);
+    }
+
+    std::string DecodedInstruction::toAssembly(const Intel8086& cpu, const assembly::Style& style) const {
+        return withInstruction(*this, std::string("<invalid instruction>"), [&](const auto& instruction) {
+            return instruction.toAssembly(cpu, style);
+        });
+    }
+
+    std::vector<u8> DecodedInstruction::getRawData() const {
+        std::vector<u8> data = { opcode };
+
+        if(hasModRegRm) data.push_back(modRegRm);
+
+        if(displacementSize > 0) data.push_back(convert::getLeastSigByte(displacement));
+        if(displacementSize > 1) data.push_back(convert::getMostSigByte(displacement));
+
+        if(immediateSize > 0) data.push_back(convert::getLeastSigByte(immediate));
+        if(immediateSize > 1) data.push_back(convert::getMostSigByte(immediate));
+
+        return data;
+    }
+
+    std::string DecodedInstruction::getRawDataString(std::string separator) const {
+        std::vector<u8> raw = getRawData();
+        std::function<std::string(u8)> convertFunction = [](u8 value) { return convert::toBinaryString<8>(value); };
+
+        return convert::vectorToString(raw, convertFunction, separator);
+    }
+}
@@ -0,0 +1,23 @@
+#include "emu/cpu/instr/flags.hpp"
+
+#include "convert.hpp"
+#include "emu/cpu/intel8086.hpp"
+
+namespace emu::cpu::instr {
+    LoadAhFromFlags::LoadAhFromFlags(Opcode instrOpcode) : Instruction("lahf", instrOpcode) {}
+
+    OffsetAddr LoadAhFromFlags::execute(Intel8086& cpu, Mem&) {
+        cpu.generalRegisters.setHigh(reg::AX_REGISTER, convert::getLeastSigByte(cpu.getFlagsWord()));
+
+        return nextAddress(cpu);
+    }
+
+    StoreAhIntoFlags::StoreAhIntoFlags(Opcode instrOpcode) : Instruction("sahf", instrOpcode) {}
+
+    OffsetAddr StoreAhIntoFlags::execute(Intel8086& cpu, Mem&) {
+        u8 high = convert::getMostSigByte(cpu.getFlagsWord());
+        cpu.setFlagsWord(convert::createWordFromBytes(cpu.generalRegisters.getHigh(reg::AX_REGISTER), high));
+
+        return nextAddress(cpu);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "emu/cpu/instr/handler.hpp"
+
+namespace emu::cpu::instr {
+    namespace {
+        #define EG_REGISTER_HANDLER(function, size, direction) handlers::egRegister<function, size, direction>,
+        #define EG_MEMORY_HANDLER(function, size, direction) handlers::egMemory<function, size, direction>,
+
+        constexpr Handler handlerTable[] = {
+            handlers::invalid, // INVALID_HANDLER
+            handlers::pushRegister, // PUSH_REGISTER_HANDLER
+            handlers::popRegister, // POP_REGISTER_HANDLER
+            handlers::halt, // HALT_HANDLER
+            handlers::pushFlags, // PUSH_FLAGS_HANDLER
+            handlers::popFlags, // POP_FLAGS_HANDLER
+            handlers::loadAhFromFlags, // LOAD_AH_FROM_FLAGS_HANDLER
+            handlers::storeAhIntoFlags, // STORE_AH_INTO_FLAGS_HANDLER
+            WIRED86_FOR_EACH_EG_VARIANT(EG_REGISTER_HANDLER) // EG_REGISTER_HANDLERS
+            WIRED86_FOR_EACH_EG_VARIANT(EG_MEMORY_HANDLER) // EG_MEMORY_HANDLERS
+            handlers::fusedPair<handlers::pushRegister, handlers::pushRegister, true>, // PUSH_PUSH_PAIR
+            handlers::fusedPair<handlers::popRegister, handlers::popRegister, false>, // POP_POP_PAIR
+            handlers::fusedPair<handlers::pushRegister, handlers::popRegister, true> // PUSH_POP_PAIR
+        };
+
+        #undef EG_MEMORY_HANDLER
+        #undef EG_REGISTER_HANDLER
+
+        static_assert(sizeof(handlerTable) / sizeof(handlerTable[0]) == HANDLER_COUNT,
+                      "Every handler identifier must have an entry in the handler table.");
+    }
+
+    Handler getHandler(HandlerId id) {
+        return handlerTable[id];
+    }
+}
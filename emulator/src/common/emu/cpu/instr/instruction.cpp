@@ -5,8 +5,8 @@
 #include "logging.hpp"
 
 namespace emu::cpu::instr {
-    Instruction::Instruction(std::string instrIdentifier, Opcode instrOpcode)
-    : identifier(instrIdentifier), opcode(instrOpcode) {}
+    Instruction::Instruction(const char* instrIdentifier, Opcode instrOpcode, OffsetAddr instrRawSize)
+    : identifier(instrIdentifier), opcode(instrOpcode), rawSize(instrRawSize) {}
 
     std::string Instruction::toAssembly(const Intel8086&, const assembly::Style&) const {
         return identifier; // By default, simply return the instruction identifier instead of proper assembly.
@@ -24,9 +24,7 @@ namespace emu::cpu::instr {
     }
 
     OffsetAddr Instruction::getRawSize() const {
-        std::size_t size = getRawData().size(); // Fetch the raw data vector in order to then obtain its size expressed
-                                                // as std::size_t type.
-        return static_cast<OffsetAddr>(size); // Cast from std::size_t at compile time (static cast).
+        return rawSize;
     }
 
     OffsetAddr Instruction::nextAddress(const Intel8086& cpu) const {
@@ -35,7 +33,7 @@ namespace emu::cpu::instr {
 
 
 
-    InstructionTakingRegister::InstructionTakingRegister(std::string instrIdentifier, Opcode instrOpcode,
+    InstructionTakingRegister::InstructionTakingRegister(const char* instrIdentifier, Opcode instrOpcode,
                                                          reg::GeneralRegister generalReg, reg::RegisterPart part)
     : Instruction(instrIdentifier, instrOpcode),
       registerIndex(generalReg), registerPart(part) {}
@@ -43,7 +41,7 @@ namespace emu::cpu::instr {
     std::string InstructionTakingRegister::toAssembly(const Intel8086& cpu, const assembly::Style&) const {
         auto registerIdentifier = cpu.generalRegisters.getAssemblyIdentifier(registerIndex, registerPart);
         
-        return identifier + " " + registerIdentifier;
+        return std::string(identifier) + " " + registerIdentifier;
     }
 
 
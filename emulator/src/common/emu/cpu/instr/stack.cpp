@@ -25,4 +25,20 @@ namespace emu::cpu::instr {
 
         return nextAddress(cpu);
     }
+
+    PushFlags::PushFlags(Opcode instrOpcode) : Instruction("pushf", instrOpcode) {}
+
+    OffsetAddr PushFlags::execute(Intel8086& cpu, Mem& memory) {
+        cpu.pushWordToStack(cpu.getFlagsWord(), memory);
+
+        return nextAddress(cpu);
+    }
+
+    PopFlags::PopFlags(Opcode instrOpcode) : Instruction("popf", instrOpcode) {}
+
+    OffsetAddr PopFlags::execute(Intel8086& cpu, Mem& memory) {
+        cpu.setFlagsWord(cpu.popWordFromStack(memory));
+
+        return nextAddress(cpu);
+    }
 }
\ No newline at end of file
@@ -1,16 +1,30 @@
 #include "emu/cpu/intel8086.hpp"
 
+#include <algorithm>
 #include "logging.hpp"
-#include "emu/cpu/instr/stack.hpp"
-#include "emu/cpu/instr/arithmeticlogic.hpp"
+#include "emu/cpu/instr/handler.hpp"
+#include "emu/cpu/instr/opcodetable.hpp"
+#include "emu/cpu/jit/translator.hpp"
 
 namespace emu::cpu {
-    AbsAddr Intel8086::resolveAddress(OffsetAddr offset, reg::SegmentRegister segment) const {
-        OffsetAddr segmentAddress = segmentRegisters.get(segment);
-
-        return (segmentAddress << 4) + offset;
+    namespace {
+        /**
+         * Read a displacement or immediate value that forms part of an instruction.
+         *
+         * @param offset Offset within the window of the first (least significant) byte.
+         * @param size Number of bytes to read (1 or 2).
+         * @return The value read (high byte will be 0 if only a single byte is read).
+         */
+        u16 readWindowData(const FetchWindow& window, unsigned int offset, u8 size) {
+            return convert::createWordFromBytes(window.bytes[offset], size > 1 ? window.bytes[offset + 1] : 0);
+        }
     }
 
+    Intel8086::Intel8086()
+        : decodeCache(std::make_unique<DecodeCache>()), blockCache(std::make_unique<BlockCache>()) {}
+
+    Intel8086::~Intel8086() = default; // Defined here as jit::Translator is incomplete in the header.
+
     OffsetAddr Intel8086::getRelativeInstructionPointer() const {
         return instructionPointer;
     }
@@ -19,122 +33,332 @@ namespace emu::cpu {
         return resolveAddress(instructionPointer, reg::CODE_SEGMENT);
     }
 
-    std::unique_ptr<instr::Instruction> Intel8086::fetchDecodeInstruction(AbsAddr address, const Mem& memory) const {
-        MemValue opcodeValue = memory.read(address);
-        instr::Opcode opcode(opcodeValue);
+    std::optional<instr::DecodedInstruction> Intel8086::fetchDecodeInstruction(AbsAddr address,
+                                                                              const Mem& memory) const {
+        const instr::DecodedInstruction* cached = decodeCache->lookup(address, memory);
+        if(cached) return *cached;
 
-        std::unique_ptr<instr::Instruction> instruction;
+        FetchWindow window = fetchWindow(address, memory);
+        auto instruction = decodeInstruction(window);
 
-        // First attempt to decode instruction without MOD-REG-R/M byte:
-        instruction = fetchDecodeWithoutModRegRm(opcode);
-        // Failing that, attempt to decode instruction with the assumption that it has a MOD-REG-R/M component:
-        if(!instruction) instruction = fetchDecodeWithModRegRm(opcode, address, memory);
-
-        if(!instruction)
-            logging::warning("Encountered instruction with nonexistent or currently unimplemented opcode: " +
-                             opcode.toString());
+        if(instruction) decodeCache->insert(address, memory, *instruction);
+        else logging::warning("Encountered instruction with nonexistent or currently unimplemented opcode: " +
+                              instr::Opcode(window.bytes[0]).toString());
 
         return instruction;
     }
 
-    std::unique_ptr<instr::Instruction> Intel8086::fetchDecodeWithoutModRegRm(const instr::Opcode& opcode) const {
-        switch(opcode.value) {
-        case 0x50: // PUSH AX
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::AX_REGISTER);
-
-        case 0x51: // PUSH CX
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::CX_REGISTER);
+    FetchWindow Intel8086::fetchWindow(AbsAddr address, const Mem& memory) const {
+        FetchWindow window;
+        window.address = address;
+        window.available = static_cast<u8>(memory.readInto(address, window.bytes, FetchWindow::MAX_INSTRUCTION_LENGTH));
 
-        case 0x52: // PUSH DX
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::DX_REGISTER);
+        return window;
+    }
 
-        case 0x53: // PUSH BX
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::BX_REGISTER);
+    FetchWindow Intel8086::fetchSegmentWindow(OffsetAddr ip, const Mem& memory) const {
+        AbsAddr address = resolveAddress(ip, reg::CODE_SEGMENT);
+        AbsAddr untilWrap = 0x10000 - ip;
 
-        case 0x54: // PUSH SP
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::STACK_POINTER);
+        if(untilWrap >= FetchWindow::MAX_INSTRUCTION_LENGTH) return fetchWindow(address, memory);
 
-        case 0x55: // PUSH BP
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::BASE_POINTER);
+        FetchWindow window;
+        window.address = address;
+        window.available = static_cast<u8>(memory.readInto(window.address, window.bytes, untilWrap));
 
-        case 0x56: // PUSH SI
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::SOURCE_INDEX);
+        if(window.available == untilWrap) { // Remainder of the window lies at the start of the code segment.
+            window.wrapped = true;
+            window.available += static_cast<u8>(memory.readInto(resolveAddress(0, reg::CODE_SEGMENT),
+                                                                window.bytes + untilWrap,
+                                                                FetchWindow::MAX_INSTRUCTION_LENGTH - untilWrap));
+        }
 
-        case 0x57: // PUSH DI
-            return std::make_unique<instr::PushTakingRegister>(opcode, reg::DESTINATION_INDEX);
+        return window;
+    }
 
-        case 0x58: // POP AX
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::AX_REGISTER);
+    std::optional<instr::DecodedInstruction> Intel8086::decodeInstruction(const FetchWindow& window) const {
+        MemValue opcodeValue = window.bytes[0];
+        const instr::OpcodeInfo& info = instr::OPCODE_TABLE[opcodeValue];
 
-        case 0x59: // POP CX
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::CX_REGISTER);
+        if(info.handler == instr::INVALID_HANDLER) return {};
 
-        case 0x5A: // POP DX
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::DX_REGISTER);
+        instr::DecodedInstruction instruction;
+        instruction.opcode = opcodeValue;
+        instruction.handler = info.handler;
+        instruction.hasModRegRm = info.hasModRegRm;
+        instruction.immediateSize = info.immediateSize;
 
-        case 0x5B: // POP BX
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::BX_REGISTER);
+        unsigned int next = 1;
 
-        case 0x5C: // POP SP
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::STACK_POINTER);
+        if(info.hasModRegRm) {
+            instr::ModRegRm modRegRm(window.bytes[next++]); // MOD-REG-R/M byte immediately follows opcode.
+            instruction.modRegRm = modRegRm.value;
 
-        case 0x5D: // POP BP
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::BASE_POINTER);
+            if(modRegRm.getAddressingMode() != instr::REGISTER_ADDRESSING_MODE) instruction.handler = info.memoryHandler;
 
-        case 0x5E: // POP SI
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::SOURCE_INDEX);
+            if(modRegRm.isDisplacementUsed()) {
+                instruction.displacementSize = static_cast<u8>(modRegRm.getDisplacementReadLength());
+                instruction.displacement = readWindowData(window, next, instruction.displacementSize);
+                if(instruction.displacementSize == 1) // Byte displacements are sign-extended.
+                    instruction.displacement = static_cast<u16>(static_cast<i8>(instruction.displacement));
+                next += instruction.displacementSize;
+            }
+        }
 
-        case 0x5F: // POP DI
-            return std::make_unique<instr::PopTakingRegister>(opcode, reg::DESTINATION_INDEX);
-        
-        case 0xF4: // HLT
-            return std::make_unique<instr::HaltInstruction>(opcode);
+        if(info.immediateSize > 0) {
+            instruction.immediate = readWindowData(window, next, info.immediateSize);
+            next += info.immediateSize;
         }
 
-        return {};
+        // Bytes beyond the end of memory read as zero, so reject the instruction only once its length is known.
+        if(next > window.available) throw Mem::OutOfBounds(window.address + window.available);
+
+        instruction.length = static_cast<u8>(next);
+
+        return instruction;
     }
 
-    std::unique_ptr<instr::Instruction> Intel8086::fetchDecodeWithModRegRm(const instr::Opcode& opcode, AbsAddr address,
-                                                                           const Mem& memory) const {
-        MemValue modRegRmValue = memory.read(address + 1); // MOD-REG-R/M byte immediately follows opcode.
-        instr::ModRegRm modRegRm(modRegRmValue);
+    const BasicBlock* Intel8086::decodeBlock(const Mem& memory) {
+        BasicBlock& block = blockCache->allocate(segmentRegisters.get(reg::CODE_SEGMENT), instructionPointer);
+
+        OffsetAddr ip = instructionPointer;
+        block.firstAddress = resolveAddress(ip, reg::CODE_SEGMENT);
+
+        while(block.count < BasicBlock::MAX_LENGTH) {
+            FetchWindow window = fetchSegmentWindow(ip, memory);
+            auto instruction = decodeInstruction(window);
+
+            if(!instruction) break; // Leave the invalid instruction to be reported when execution reaches it.
+
+            block.instructions[block.count++] = *instruction;
+
+            if(window.wrapped && ip + instruction->length > 0x10000) {
+                // Instruction straddles the end of the code segment so the block covers the whole segment.
+                block.firstAddress = resolveAddress(0, reg::CODE_SEGMENT);
+                block.lastAddress = block.firstAddress + 0xFFFF;
+            }
+            else block.lastAddress = window.address + instruction->length - 1;
+
+            if(block.lastAddress < block.firstAddress || block.lastAddress > ABSOLUTE_ADDRESS_MASK) {
+                // Block wraps around at 1 MiB so cannot be described by a single range - cover all of memory instead.
+                block.firstAddress = 0;
+                block.lastAddress = ABSOLUTE_ADDRESS_MASK;
+            }
+
+            if(memory.getAccessMode() == Mem::CHECKED_ACCESS)
+                block.lastAddress = std::min<AbsAddr>(block.lastAddress, memory.size - 1);
 
-        std::optional<instr::Displacement> displacement;
+            OffsetAddr nextIp = ip + instruction->length;
 
-        if(modRegRm.isDisplacementUsed()) {
-            auto displacementValues = memory.read(address + 2, modRegRm.getDisplacementReadLength());
-            displacement = instr::Displacement(displacementValues);
+            if(instr::OPCODE_TABLE[instruction->opcode].endsBlock || nextIp < ip) break; // Control transfer or wrap.
+            ip = nextIp;
         }
 
-        switch(opcode.getUniqueValue()) {
-        case 0b000000: // ADD E, G
-            return std::make_unique<instr::AddEG>(opcode, modRegRm, displacement);
+        if(block.count == 0) return nullptr;
+
+        // Instructions that form an enabled pair with their successor may be executed together with it:
+        for(unsigned int i = 0; i + 1 < block.count; i++) {
+            instr::FusedPair pair = instr::getFusedPair(block.instructions[i].handler,
+                                                        block.instructions[i + 1].handler);
+
+            if(pair != instr::FUSED_PAIR_COUNT && pairFusion[pair])
+                block.instructions[i].pairHandler = instr::getFusedPairHandler(pair);
         }
 
-        return {};
+        blockCache->commit(block, memory);
+        return &block;
     }
 
-    bool Intel8086::executeInstruction(std::unique_ptr<instr::Instruction>& instruction, Mem& memory) {
+    bool Intel8086::executeInstruction(const instr::DecodedInstruction& instruction, Mem& memory) {
         if(halted) {
             logging::warning("Instruction could not be executed due to halted CPU state.");
             return false;
         }
 
-        if(instruction) {
-            OffsetAddr newIp = instruction->execute(*this, memory);
+        OffsetAddr newIp = instr::getHandler(instruction.handler)(*this, memory, instruction);
 
-            if(memory.withinBounds(newIp)) {
-                instructionPointer = newIp;
+        return completeExecution(newIp, memory);
+    }
 
-                return true; // Success!
-            }
-            else logging::error("Instruction returned new instruction pointer value that is out of bounds!");
+    bool Intel8086::executeInstruction(instr::Instruction& instruction, Mem& memory) {
+        if(halted) {
+            logging::warning("Instruction could not be executed due to halted CPU state.");
+            return false;
+        }
+
+        OffsetAddr newIp = instruction.execute(*this, memory);
+
+        return completeExecution(newIp, memory);
+    }
+
+    bool Intel8086::completeExecution(OffsetAddr newIp, const Mem& memory) {
+        // Any instruction pointer is valid should addresses beyond the end of memory wrap around or fault quietly:
+        if(memory.getAccessMode() != Mem::CHECKED_ACCESS || memory.withinBounds(newIp)) {
+            instructionPointer = newIp;
+
+            return true; // Success!
         }
-        else logging::error("Empty instruction pointer passed to CPU.");
 
+        logging::error("Instruction returned new instruction pointer value that is out of bounds!");
         return false;
     }
 
+    BlockResult Intel8086::executeBlock(Mem& memory, unsigned int maxInstructions) {
+        BlockResult result;
+
+        if(halted) {
+            logging::warning("Block could not be executed due to halted CPU state.");
+            return result;
+        }
+
+        const BasicBlock* block = fetchBlock(memory);
+
+        if(!block) {
+            logging::error("Failed to decode instruction at beginning of block.");
+            return result;
+        }
+
+        return runBlock(*block, std::min(block->count, maxInstructions), memory);
+    }
+
+    RunResult Intel8086::run(Mem& memory, unsigned long budget) {
+        RunResult result;
+
+        while(true) {
+            if(halted) {
+                result.reason = HALTED_STOP;
+                return result;
+            }
+
+            if(result.instructionsRetired >= budget) {
+                result.reason = BUDGET_STOP;
+                return result;
+            }
+
+            const BasicBlock* block = fetchBlock(memory);
+
+            if(!block) {
+                result.reason = DECODE_FAILURE_STOP;
+                return result;
+            }
+
+            unsigned long remaining = budget - result.instructionsRetired;
+            unsigned int count = remaining < block->count ? static_cast<unsigned int>(remaining) : block->count;
+
+            if(!breakpoints.empty()) {
+                // A breakpoint at the very first instruction is ignored so that execution may be resumed:
+                count = findBreakpoint(*block, result.instructionsRetired == 0 ? 1 : 0, count);
+
+                if(count == 0) {
+                    result.reason = BREAKPOINT_STOP;
+                    return result;
+                }
+            }
+
+            BlockResult blockResult = runBlock(*block, count, memory);
+            result.instructionsRetired += blockResult.instructionsExecuted;
+
+            if(!blockResult.success) {
+                result.reason = EXECUTION_FAILURE_STOP;
+                return result;
+            }
+        }
+    }
+
+    void Intel8086::addBreakpoint(AbsAddr address) {
+        breakpoints.insert(address);
+    }
+
+    void Intel8086::removeBreakpoint(AbsAddr address) {
+        breakpoints.erase(address);
+    }
+
+    void Intel8086::clearBreakpoints() {
+        breakpoints.clear();
+    }
+
+    bool Intel8086::hasBreakpoint(AbsAddr address) const {
+        return breakpoints.count(address) > 0;
+    }
+
+    const BasicBlock* Intel8086::fetchBlock(const Mem& memory) {
+        const BasicBlock* block = blockCache->lookup(segmentRegisters.get(reg::CODE_SEGMENT), instructionPointer,
+                                                    memory);
+
+        return block ? block : decodeBlock(memory);
+    }
+
+    BlockResult Intel8086::runBlock(const BasicBlock& block, unsigned int count, Mem& memory) {
+        BlockResult result;
+
+        if(translator && translator->execute(*this, block, memory, count, result)) return result;
+
+        return interpretBlock(block, count, memory);
+    }
+
+    unsigned int Intel8086::findBreakpoint(const BasicBlock& block, unsigned int start, unsigned int count) const {
+        OffsetAddr ip = block.instructionPointer;
+
+        for(unsigned int i = 0; i < count; i++) {
+            if(i >= start && hasBreakpoint(resolveAddress(ip, reg::CODE_SEGMENT))) return i;
+            ip = static_cast<OffsetAddr>(ip + block.instructions[i].length);
+        }
+
+        return count;
+    }
+
+    bool Intel8086::setJitEnabled(bool enabled) {
+        if(!enabled) translator.reset();
+        else if(!translator && jit::Translator::isAvailable()) translator = std::make_unique<jit::Translator>();
+
+        return isJitEnabled();
+    }
+
+    bool Intel8086::isJitEnabled() const {
+        return static_cast<bool>(translator);
+    }
+
+    const jit::Translator* Intel8086::getTranslator() const {
+        return translator.get();
+    }
+
+    bool Intel8086::getFlag(reg::Flag flag) const {
+        return flags.get(flag);
+    }
+
+    void Intel8086::setFlag(reg::Flag flag, bool value) {
+        flags.set(flag, value);
+    }
+
+    u16 Intel8086::getFlagsWord() const {
+        return flags.getWord();
+    }
+
+    void Intel8086::setFlagsWord(u16 value) {
+        flags.setWord(value);
+    }
+
+    const DecodeCache& Intel8086::getDecodeCache() const {
+        return *decodeCache;
+    }
+
+    const BlockCache& Intel8086::getBlockCache() const {
+        return *blockCache;
+    }
+
+    void Intel8086::setPairFusion(instr::FusedPair pair, bool enabled) {
+        pairFusion[pair] = enabled;
+        blockCache->clear();
+    }
+
+    bool Intel8086::isPairFusionEnabled(instr::FusedPair pair) const {
+        return pairFusion[pair];
+    }
+
+    unsigned long Intel8086::getFusedPairExecutions() const {
+        return fusedPairExecutions;
+    }
+
     void Intel8086::pushToStack(MemValue value, Mem& memory) {
         OffsetAddr stackPointer = generalRegisters.get(reg::STACK_POINTER);
         
@@ -158,17 +382,6 @@ namespace emu::cpu {
         return memory.read(address);
     }
 
-    void Intel8086::pushWordToStack(u16 value, Mem& memory) {
-        pushToStack(convert::getMostSigByte(value), memory);
-        pushToStack(convert::getLeastSigByte(value), memory);
-    }
-
-    u16 Intel8086::popWordFromStack(const Mem& memory) {
-        u8 low = popFromStack(memory);
-        u8 high = popFromStack(memory);
-        return convert::createWordFromBytes(low, high);
-    }
-
     void Intel8086::performRelativeJump(OffsetAddr offset) {
         instructionPointer = offset;
         // TODO: Ensure the jump is within bounds.
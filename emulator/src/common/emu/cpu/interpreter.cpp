@@ -0,0 +1,197 @@
+#include "emu/cpu/intel8086.hpp"
+
+#include "emu/cpu/instr/handler.hpp"
+
+/*
+ * The threaded interpreter relies on the 'labels as values' extension supported by GCC and Clang. Each handler is
+ * inlined at its own label and ends with its own dispatch to the next instruction, meaning that the indirect branch
+ * at the end of every handler is predicted separately rather than every instruction sharing a single dispatch branch.
+ */
+#if defined(WIRED86_THREADED_INTERPRETER) && !defined(__GNUC__)
+    #error "The threaded interpreter requires a compiler supporting labels as values (GCC or Clang)."
+#endif
+
+namespace emu::cpu {
+#ifdef WIRED86_THREADED_INTERPRETER
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wpedantic" // Labels as values are a GNU extension.
+
+    BlockResult Intel8086::interpretBlock(const BasicBlock& block, unsigned int count, Mem& memory) {
+        #define EG_REGISTER_LABEL(function, size, direction) &&egRegister_##function##_##size##_##direction,
+        #define EG_MEMORY_LABEL(function, size, direction) &&egMemory_##function##_##size##_##direction,
+
+        static void* const dispatchTable[] = {
+            &&invalid, // INVALID_HANDLER
+            &&pushRegister, // PUSH_REGISTER_HANDLER
+            &&popRegister, // POP_REGISTER_HANDLER
+            &&halt, // HALT_HANDLER
+            &&pushFlags, // PUSH_FLAGS_HANDLER
+            &&popFlags, // POP_FLAGS_HANDLER
+            &&loadAhFromFlags, // LOAD_AH_FROM_FLAGS_HANDLER
+            &&storeAhIntoFlags, // STORE_AH_INTO_FLAGS_HANDLER
+            WIRED86_FOR_EACH_EG_VARIANT(EG_REGISTER_LABEL) // EG_REGISTER_HANDLERS
+            WIRED86_FOR_EACH_EG_VARIANT(EG_MEMORY_LABEL) // EG_MEMORY_HANDLERS
+            &&pushPushPair, // PUSH_PUSH_PAIR
+            &&popPopPair, // POP_POP_PAIR
+            &&pushPopPair // PUSH_POP_PAIR
+        };
+
+        #undef EG_MEMORY_LABEL
+        #undef EG_REGISTER_LABEL
+
+        static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == instr::HANDLER_COUNT,
+                      "Every handler must have a label in the threaded interpreter dispatch table.");
+
+        BlockResult result;
+        const instr::DecodedInstruction* instruction;
+        OffsetAddr expectedIp, newIp;
+        u32 writeCount = memory.getWriteCount();
+
+        // Jump to the handler of the next instruction in the block (or leave if there are no instructions left). The
+        // handler of a fused pair is only used should both instructions of the pair be permitted to execute:
+        #define DISPATCH() \
+            if(result.instructionsExecuted == count) goto done; \
+            instruction = &block.instructions[result.instructionsExecuted]; \
+            expectedIp = instructionPointer + instruction->length; \
+            if(instruction->pairHandler != instr::INVALID_HANDLER && result.instructionsExecuted + 1 < count) \
+                goto *dispatchTable[instruction->pairHandler]; \
+            goto *dispatchTable[instruction->handler]
+
+        // Complete execution of the current instruction exactly as Intel8086::executeInstruction would, leave the
+        // block should the CPU halt, control be transferred, or the block's memory be written to, and then dispatch.
+        // The block's range is only checked for writes should memory have been written to at all:
+        #define COMPLETE() \
+            if(!completeExecution(newIp, memory)) return result; \
+            result.instructionsExecuted++; \
+            if(halted || newIp != expectedIp) goto done; \
+            if(memory.getWriteCount() != writeCount) { \
+                writeCount = memory.getWriteCount(); \
+                if(blockCache->isStale(block, memory)) goto done; \
+            } \
+            DISPATCH()
+
+        // Account for the second instruction of a fused pair (unless the first prevented it from executing):
+        #define COMPLETE_PAIR() \
+            if(newIp != expectedIp) { \
+                expectedIp += instruction[1].length; \
+                result.instructionsExecuted++; \
+                fusedPairExecutions++; \
+            } \
+            COMPLETE()
+
+        DISPATCH();
+
+    invalid:
+        newIp = instr::handlers::invalid(*this, memory, *instruction);
+        COMPLETE();
+
+    pushRegister:
+        newIp = instr::handlers::pushRegister(*this, memory, *instruction);
+        COMPLETE();
+
+    popRegister:
+        newIp = instr::handlers::popRegister(*this, memory, *instruction);
+        COMPLETE();
+
+    halt:
+        newIp = instr::handlers::halt(*this, memory, *instruction);
+        COMPLETE();
+
+    pushFlags:
+        newIp = instr::handlers::pushFlags(*this, memory, *instruction);
+        COMPLETE();
+
+    popFlags:
+        newIp = instr::handlers::popFlags(*this, memory, *instruction);
+        COMPLETE();
+
+    loadAhFromFlags:
+        newIp = instr::handlers::loadAhFromFlags(*this, memory, *instruction);
+        COMPLETE();
+
+    storeAhIntoFlags:
+        newIp = instr::handlers::storeAhIntoFlags(*this, memory, *instruction);
+        COMPLETE();
+
+        // Each E, G handler variant at its own label:
+        #define EG_REGISTER_CASE(function, size, direction) \
+            egRegister_##function##_##size##_##direction: \
+            newIp = instr::handlers::egRegister<instr::function, instr::size, instr::direction>(*this, memory, \
+                                                                                              *instruction); \
+            COMPLETE();
+
+        #define EG_MEMORY_CASE(function, size, direction) \
+            egMemory_##function##_##size##_##direction: \
+            newIp = instr::handlers::egMemory<instr::function, instr::size, instr::direction>(*this, memory, \
+                                                                                            *instruction); \
+            COMPLETE();
+
+        WIRED86_FOR_EACH_EG_VARIANT(EG_REGISTER_CASE)
+        WIRED86_FOR_EACH_EG_VARIANT(EG_MEMORY_CASE)
+
+        #undef EG_MEMORY_CASE
+        #undef EG_REGISTER_CASE
+
+    pushPushPair:
+        newIp = instr::handlers::fusedPair<instr::handlers::pushRegister, instr::handlers::pushRegister, true>(
+            *this, memory, *instruction);
+        COMPLETE_PAIR();
+
+    popPopPair:
+        newIp = instr::handlers::fusedPair<instr::handlers::popRegister, instr::handlers::popRegister, false>(
+            *this, memory, *instruction);
+        COMPLETE_PAIR();
+
+    pushPopPair:
+        newIp = instr::handlers::fusedPair<instr::handlers::pushRegister, instr::handlers::popRegister, true>(
+            *this, memory, *instruction);
+        COMPLETE_PAIR();
+
+    done:
+        #undef COMPLETE_PAIR
+        #undef COMPLETE
+        #undef DISPATCH
+
+        result.success = true;
+        return result;
+    }
+
+    #pragma GCC diagnostic pop
+#else
+    BlockResult Intel8086::interpretBlock(const BasicBlock& block, unsigned int count, Mem& memory) {
+        BlockResult result;
+        u32 writeCount = memory.getWriteCount();
+
+        for(unsigned int i = 0; i < count; i++) {
+            const instr::DecodedInstruction& instruction = block.instructions[i];
+
+            // The handler of a fused pair is only used should both instructions be permitted to execute:
+            bool pair = instruction.pairHandler != instr::INVALID_HANDLER && i + 1 < count;
+
+            OffsetAddr expectedIp = instructionPointer + instruction.length;
+            OffsetAddr newIp = instr::getHandler(pair ? instruction.pairHandler : instruction.handler)(*this, memory,
+                                                                                                      instruction);
+
+            if(pair && newIp != expectedIp) { // Second instruction of the pair was executed too.
+                expectedIp += block.instructions[++i].length;
+                result.instructionsExecuted++;
+                fusedPairExecutions++;
+            }
+
+            if(!completeExecution(newIp, memory)) return result;
+            result.instructionsExecuted++;
+
+            // Leave the block should the CPU halt, control be transferred, or the block's memory be written to:
+            if(halted || newIp != expectedIp) break;
+
+            if(memory.getWriteCount() != writeCount) {
+                writeCount = memory.getWriteCount();
+                if(blockCache->isStale(block, memory)) break;
+            }
+        }
+
+        result.success = true;
+        return result;
+    }
+#endif
+}
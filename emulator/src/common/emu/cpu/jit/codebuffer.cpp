@@ -0,0 +1,62 @@
+#include "emu/cpu/jit/codebuffer.hpp"
+
+#include <cstring>
+#include "logging.hpp"
+
+#ifdef WIRED86_JIT_AVAILABLE
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace emu::cpu::jit {
+#ifdef WIRED86_JIT_AVAILABLE
+    CodeBuffer::CodeBuffer(std::size_t bufferSize) {
+        std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t roundedSize = (bufferSize + pageSize - 1) / pageSize * pageSize;
+
+        void* mapping = mmap(nullptr, roundedSize, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if(mapping != MAP_FAILED) {
+            buffer = static_cast<u8*>(mapping);
+            size = roundedSize;
+        }
+        else logging::error("Failed to allocate executable memory for translated code.");
+    }
+
+    CodeBuffer::~CodeBuffer() {
+        if(buffer) munmap(buffer, size);
+    }
+
+    const void* CodeBuffer::append(const std::vector<u8>& code) {
+        if(!buffer || code.size() > size - used) return nullptr;
+
+        if(mprotect(buffer, size, PROT_READ | PROT_WRITE) != 0) return nullptr;
+
+        u8* destination = buffer + used;
+        std::memcpy(destination, code.data(), code.size());
+        used += code.size();
+
+        if(mprotect(buffer, size, PROT_READ | PROT_EXEC) != 0) {
+            logging::error("Failed to make translated code executable.");
+            return nullptr;
+        }
+
+        return destination;
+    }
+#else
+    CodeBuffer::CodeBuffer(std::size_t) {}
+    CodeBuffer::~CodeBuffer() {}
+
+    const void* CodeBuffer::append(const std::vector<u8>&) {
+        return nullptr;
+    }
+#endif
+
+    void CodeBuffer::reset() {
+        used = 0;
+    }
+
+    std::size_t CodeBuffer::getUsed() const {
+        return used;
+    }
+}
@@ -0,0 +1,200 @@
+#include "emu/cpu/jit/emitter.hpp"
+
+namespace emu::cpu::jit {
+    void Emitter::push(HostRegister reg) { emit({ static_cast<u8>(0x50 + reg) }); }
+    void Emitter::pop(HostRegister reg) { emit({ static_cast<u8>(0x58 + reg) }); }
+    void Emitter::ret() { emit({ 0xC3 }); }
+    void Emitter::subRspImmediate(u8 value) { emit({ 0x48, 0x83, 0xEC, value }); }
+    void Emitter::addRspImmediate(u8 value) { emit({ 0x48, 0x83, 0xC4, value }); }
+
+    void Emitter::movRegister64(HostRegister destination, HostRegister source) {
+        emit({ 0x48, 0x89 });
+        emitRegisterOperand(source, destination);
+    }
+
+    void Emitter::movRegister(HostRegister destination, HostRegister source) {
+        emit({ 0x89 });
+        emitRegisterOperand(source, destination);
+    }
+
+    void Emitter::movImmediate(HostRegister reg, u32 value) {
+        emit({ static_cast<u8>(0xB8 + reg) });
+        emit32(value);
+    }
+
+    void Emitter::load64(HostRegister destination, HostRegister base, u8 offset) {
+        emit({ 0x48, 0x8B });
+        emitMemoryOperand(destination, base, offset);
+    }
+
+    void Emitter::load(HostRegister destination, HostRegister base, u8 offset) {
+        emit({ 0x8B });
+        emitMemoryOperand(destination, base, offset);
+    }
+
+    void Emitter::loadZeroExtendedWord(HostRegister destination, HostRegister base, u8 offset) {
+        emit({ 0x0F, 0xB7 });
+        emitMemoryOperand(destination, base, offset);
+    }
+
+    void Emitter::loadZeroExtendedByte(HostRegister destination, HostRegister base, u8 offset) {
+        emit({ 0x0F, 0xB6 });
+        emitMemoryOperand(destination, base, offset);
+    }
+
+    void Emitter::storeWord(HostRegister base, u8 offset, HostRegister source) {
+        emit({ 0x66, 0x89 });
+        emitMemoryOperand(source, base, offset);
+    }
+
+    void Emitter::storeByte(HostRegister base, u8 offset, HostRegister source) {
+        emit({ 0x88 });
+        emitMemoryOperand(source, base, offset);
+    }
+
+    void Emitter::storeWordImmediate(HostRegister base, u8 offset, u16 value) {
+        emit({ 0x66, 0xC7 });
+        emitMemoryOperand(0, base, offset);
+        emit16(value);
+    }
+
+    void Emitter::storeByteImmediate(HostRegister base, u8 offset, u8 value) {
+        emit({ 0xC6 });
+        emitMemoryOperand(0, base, offset);
+        emit({ value });
+    }
+
+    void Emitter::loadZeroExtendedWordIndexed(HostRegister destination, HostRegister base, HostRegister index) {
+        emit({ 0x0F, 0xB7 });
+        emitIndexedOperand(destination, base, index);
+    }
+
+    void Emitter::storeWordIndexed(HostRegister base, HostRegister index, HostRegister source) {
+        emit({ 0x66, 0x89 });
+        emitIndexedOperand(source, base, index);
+    }
+
+    void Emitter::storeByteImmediateIndexed(HostRegister base, HostRegister index, u8 value) {
+        emit({ 0xC6 });
+        emitIndexedOperand(0, base, index);
+        emit({ value });
+    }
+
+    void Emitter::incrementDwordIndexed(HostRegister base, HostRegister index) {
+        emit({ 0xFF });
+        emitIndexedOperand(0, base, index, 2);
+    }
+
+    void Emitter::incrementDword(HostRegister base) { emit({ 0xFF, static_cast<u8>(base) }); }
+
+    void Emitter::alu(u8 function, HostRegister destination, HostRegister source) {
+        emit({ static_cast<u8>(function << 3 | 0x01) });
+        emitRegisterOperand(source, destination);
+    }
+
+    void Emitter::aluWord(u8 function, HostRegister destination, HostRegister source) {
+        emit({ 0x66, static_cast<u8>(function << 3 | 0x01) });
+        emitRegisterOperand(source, destination);
+    }
+
+    void Emitter::aluByte(u8 function, HostRegister destination, HostRegister source) {
+        emit({ static_cast<u8>(function << 3) });
+        emitRegisterOperand(source, destination);
+    }
+
+    void Emitter::aluImmediate8(u8 function, HostRegister reg, u8 value) {
+        emit({ 0x83 });
+        emitRegisterOperand(function, reg);
+        emit({ value });
+    }
+
+    void Emitter::compareImmediate(HostRegister reg, u32 value) {
+        emit({ 0x81 });
+        emitRegisterOperand(7, reg);
+        emit32(value);
+    }
+
+    void Emitter::compare(HostRegister reg, HostRegister base, u8 offset) {
+        emit({ 0x3B });
+        emitMemoryOperand(reg, base, offset);
+    }
+
+    void Emitter::test(HostRegister a, HostRegister b) {
+        emit({ 0x85 });
+        emitRegisterOperand(b, a);
+    }
+
+    void Emitter::shiftRightImmediate(HostRegister reg, u8 count) {
+        emit({ 0xC1 });
+        emitRegisterOperand(5, reg);
+        emit({ count });
+    }
+
+    void Emitter::loadEffectiveAddress(HostRegister destination, HostRegister base, u8 offset) {
+        emit({ 0x8D });
+        emitMemoryOperand(destination, base, offset);
+    }
+
+    void Emitter::callAbsolute(const void* function) {
+        emit({ 0x48, 0xB8 }); // mov rax, imm64
+        emit64(reinterpret_cast<u64>(function));
+        emit({ 0xFF, 0xD0 }); // call rax
+    }
+
+    Emitter::Label Emitter::jump() {
+        emit({ 0xE9 });
+        Label label = code.size();
+        emit32(0); // Placeholder offset.
+
+        return label;
+    }
+
+    Emitter::Label Emitter::jump(JumpCondition condition) {
+        emit({ 0x0F, static_cast<u8>(0x80 + condition) });
+        Label label = code.size();
+        emit32(0); // Placeholder offset.
+
+        return label;
+    }
+
+    void Emitter::bind(Label label) {
+        u32 offset = static_cast<u32>(code.size() - (label + 4)); // Relative to the end of the jump instruction.
+
+        for(unsigned int i = 0; i < 4; i++)
+            code[label + i] = static_cast<u8>(offset >> (i * 8));
+    }
+
+    const std::vector<u8>& Emitter::getCode() const {
+        return code;
+    }
+
+    void Emitter::emit(std::initializer_list<u8> bytes) {
+        code.insert(code.end(), bytes.begin(), bytes.end());
+    }
+
+    void Emitter::emit16(u16 value) {
+        emit({ static_cast<u8>(value), static_cast<u8>(value >> 8) });
+    }
+
+    void Emitter::emit32(u32 value) {
+        emit16(static_cast<u16>(value));
+        emit16(static_cast<u16>(value >> 16));
+    }
+
+    void Emitter::emit64(u64 value) {
+        emit32(static_cast<u32>(value));
+        emit32(static_cast<u32>(value >> 32));
+    }
+
+    void Emitter::emitMemoryOperand(u8 reg, HostRegister base, u8 offset) {
+        emit({ static_cast<u8>(0x40 | reg << 3 | base), offset }); // MOD 01: 8-bit displacement.
+    }
+
+    void Emitter::emitIndexedOperand(u8 reg, HostRegister base, HostRegister index, u8 scale) {
+        emit({ static_cast<u8>(reg << 3 | 0b100), static_cast<u8>(scale << 6 | index << 3 | base) }); // R/M 100: SIB.
+    }
+
+    void Emitter::emitRegisterOperand(u8 reg, HostRegister rm) {
+        emit({ static_cast<u8>(0xC0 | reg << 3 | rm) }); // MOD 11: register.
+    }
+}
@@ -0,0 +1,430 @@
+#include "emu/cpu/jit/translator.hpp"
+
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+#include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/instr/handler.hpp"
+#include "emu/cpu/jit/emitter.hpp"
+
+namespace emu::cpu::jit {
+    static_assert(std::is_standard_layout_v<Context>, "Translated code relies on the layout of the context.");
+    static_assert(offsetof(Context, writeCount) < 0x80, "Members must be addressable with an 8-bit displacement.");
+
+    namespace {
+        /// Values returned to translated code by helper functions.
+        enum HelperResult : u32 {
+            HELPER_CONTINUE, /// Continue executing the block.
+            HELPER_STOP, /// Leave the block after the current instruction (its memory has been written to).
+            HELPER_FAULT /// Leave the block before the current instruction (an exception was thrown).
+        };
+
+        /// Throughout translated code, RBX holds a pointer to the context and RBP a pointer to the register file.
+        constexpr HostRegister CONTEXT = RBX_HOST_REGISTER;
+        constexpr HostRegister REGISTERS = RBP_HOST_REGISTER;
+
+        /// Displacement from the context pointer of a member of the context.
+        u8 contextOffset(std::size_t offset) {
+            return static_cast<u8>(offset);
+        }
+
+        /// Displacement from the register file pointer of a register (or byte of one).
+        u8 getRegisterOffset(reg::GeneralRegister index, reg::RegisterPart part = reg::FULL_WORD) {
+            std::size_t offset = index * sizeof(u16);
+            if(part == reg::HIGH_BYTE) offset++; // Registers are stored little endian.
+
+            return static_cast<u8>(offset);
+        }
+
+        HelperResult checkBlockUnmodified(const Context* context) {
+            bool stale = context->memory->getGeneration(context->blockFirstAddress, context->blockLastAddress) !=
+                         context->blockGeneration;
+
+            return stale ? HELPER_STOP : HELPER_CONTINUE;
+        }
+
+        u32 pushRegisterHelper(Context* context, u32 index) {
+            Intel8086& cpu = *context->cpu;
+
+            try {
+                u16 value = cpu.generalRegisters.get(static_cast<reg::GeneralRegister>(index));
+                cpu.pushWordToStack(value, *context->memory);
+            }
+            catch(...) {
+                *context->exception = std::current_exception();
+                return HELPER_FAULT;
+            }
+
+            return checkBlockUnmodified(context);
+        }
+
+        u32 popRegisterHelper(Context* context, u32 index) {
+            Intel8086& cpu = *context->cpu;
+
+            try {
+                u16 value = cpu.popWordFromStack(*context->memory);
+                cpu.generalRegisters.set(static_cast<reg::GeneralRegister>(index), value);
+            }
+            catch(...) {
+                *context->exception = std::current_exception();
+                return HELPER_FAULT;
+            }
+
+            return HELPER_CONTINUE;
+        }
+
+        /**
+         * Returns whether E, G instructions performing the given function can be translated. ADC and SBB are not as
+         * they depend upon the carry flag, which translated code does not track.
+         */
+        bool isTranslatable(instr::AluFunction function) {
+            return function != instr::ADC_FUNCTION && function != instr::SBB_FUNCTION;
+        }
+
+        /// Jumps taken should an instruction need to leave the block early (see HelperResult).
+        struct HelperExit {
+            std::vector<Emitter::Label> labels; /// Each is taken with the HelperResult in EAX.
+            OffsetAddr instructionPointer, nextInstructionPointer; /// Addresses of the instruction and the next.
+            unsigned int index; /// Index of the instruction within the block.
+        };
+
+        /**
+         * Emit code leaving translated code with the given instruction pointer and number of executed instructions.
+         */
+        void emitExit(Emitter& emitter, OffsetAddr instructionPointer, unsigned int executed) {
+            emitter.storeWordImmediate(CONTEXT, contextOffset(offsetof(Context, instructionPointer)),
+                                       instructionPointer);
+            emitter.movImmediate(RAX_HOST_REGISTER, executed);
+            emitter.addRspImmediate(8);
+            emitter.pop(REGISTERS);
+            emitter.pop(CONTEXT);
+            emitter.ret();
+        }
+
+        /**
+         * Emit code calculating the absolute address of the word at the stack pointer (held zero-extended in EAX) into
+         * ECX, jumping to the returned label should the word not be directly accessible.
+         */
+        Emitter::Label emitStackAddress(Emitter& emitter) {
+            emitter.load(RCX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, stackBase)));
+            emitter.alu(instr::ADD_FUNCTION, RCX_HOST_REGISTER, RAX_HOST_REGISTER);
+            emitter.compare(RCX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, stackLimit)));
+
+            return emitter.jump(ABOVE_OR_EQUAL_CONDITION);
+        }
+
+        /**
+         * Emit code performing the bookkeeping of Memory::writeWord for the word at the absolute address in ECX.
+         */
+        void emitWordWritten(Emitter& emitter) {
+            // Increment the generations of the regions of both values (possibly the same region twice):
+            emitter.load64(RDX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, regionGenerations)));
+
+            emitter.movRegister(RAX_HOST_REGISTER, RCX_HOST_REGISTER);
+            emitter.shiftRightImmediate(RAX_HOST_REGISTER, Mem::REGION_SHIFT);
+            emitter.incrementDwordIndexed(RDX_HOST_REGISTER, RAX_HOST_REGISTER);
+            emitter.loadEffectiveAddress(RAX_HOST_REGISTER, RCX_HOST_REGISTER, 1);
+            emitter.shiftRightImmediate(RAX_HOST_REGISTER, Mem::REGION_SHIFT);
+            emitter.incrementDwordIndexed(RDX_HOST_REGISTER, RAX_HOST_REGISTER);
+
+            emitter.load64(RDX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, dirtyPages)));
+
+            emitter.movRegister(RAX_HOST_REGISTER, RCX_HOST_REGISTER);
+            emitter.shiftRightImmediate(RAX_HOST_REGISTER, Mem::PAGE_SHIFT);
+            emitter.storeByteImmediateIndexed(RDX_HOST_REGISTER, RAX_HOST_REGISTER, 1);
+            emitter.loadEffectiveAddress(RAX_HOST_REGISTER, RCX_HOST_REGISTER, 1);
+            emitter.shiftRightImmediate(RAX_HOST_REGISTER, Mem::PAGE_SHIFT);
+            emitter.storeByteImmediateIndexed(RDX_HOST_REGISTER, RAX_HOST_REGISTER, 1);
+
+            emitter.load64(RDX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, writeCount)));
+            emitter.incrementDword(RDX_HOST_REGISTER);
+        }
+
+        /**
+         * Emit a PUSH register instruction, calling the helper function should the stack not be directly accessible.
+         */
+        void emitPush(Emitter& emitter, reg::GeneralRegister source, HelperExit& exit) {
+            u8 stackPointer = getRegisterOffset(reg::STACK_POINTER);
+
+            // Words straddling the end of the stack segment (or wrapping around to its end) are left to the helper:
+            emitter.loadZeroExtendedWord(RAX_HOST_REGISTER, REGISTERS, stackPointer);
+            emitter.aluImmediate8(instr::CMP_FUNCTION, RAX_HOST_REGISTER, 2);
+            Emitter::Label wraps = emitter.jump(BELOW_CONDITION);
+            emitter.aluImmediate8(instr::SUB_FUNCTION, RAX_HOST_REGISTER, 2);
+
+            Emitter::Label indirect = emitStackAddress(emitter);
+
+            // The value is read before the stack pointer is updated, as by the interpreter:
+            emitter.loadZeroExtendedWord(RSI_HOST_REGISTER, REGISTERS, getRegisterOffset(source));
+            emitter.load64(RDX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, memoryData)));
+            emitter.storeWordIndexed(RDX_HOST_REGISTER, RCX_HOST_REGISTER, RSI_HOST_REGISTER);
+            emitter.storeWord(REGISTERS, stackPointer, RAX_HOST_REGISTER);
+
+            emitWordWritten(emitter);
+
+            // Leave the block after this instruction should the word overlap the memory the block was decoded from:
+            emitter.loadEffectiveAddress(RAX_HOST_REGISTER, RCX_HOST_REGISTER, 1);
+            emitter.compare(RAX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, blockFirstAddress)));
+            Emitter::Label before = emitter.jump(BELOW_CONDITION);
+            emitter.compare(RCX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, blockLastAddress)));
+            Emitter::Label after = emitter.jump(ABOVE_CONDITION);
+            emitter.movImmediate(RAX_HOST_REGISTER, HELPER_STOP);
+            exit.labels.push_back(emitter.jump());
+
+            emitter.bind(wraps);
+            emitter.bind(indirect);
+            emitter.movRegister64(RDI_HOST_REGISTER, CONTEXT);
+            emitter.movImmediate(RSI_HOST_REGISTER, source);
+            emitter.callAbsolute(reinterpret_cast<const void*>(pushRegisterHelper));
+            emitter.test(RAX_HOST_REGISTER, RAX_HOST_REGISTER);
+            exit.labels.push_back(emitter.jump(NOT_EQUAL_CONDITION));
+
+            emitter.bind(before);
+            emitter.bind(after);
+        }
+
+        /**
+         * Emit a POP register instruction, calling the helper function should the stack not be directly accessible.
+         */
+        void emitPop(Emitter& emitter, reg::GeneralRegister destination, HelperExit& exit) {
+            u8 stackPointer = getRegisterOffset(reg::STACK_POINTER);
+
+            // Words straddling the end of the stack segment are left to the helper:
+            emitter.loadZeroExtendedWord(RAX_HOST_REGISTER, REGISTERS, stackPointer);
+            emitter.compareImmediate(RAX_HOST_REGISTER, 0xFFFF);
+            Emitter::Label wraps = emitter.jump(EQUAL_CONDITION);
+
+            Emitter::Label indirect = emitStackAddress(emitter);
+
+            emitter.load64(RDX_HOST_REGISTER, CONTEXT, contextOffset(offsetof(Context, memoryData)));
+            emitter.loadZeroExtendedWordIndexed(RDX_HOST_REGISTER, RDX_HOST_REGISTER, RCX_HOST_REGISTER);
+
+            // The stack pointer is updated before the register is written, as by the interpreter (for POP SP):
+            emitter.aluImmediate8(instr::ADD_FUNCTION, RAX_HOST_REGISTER, 2);
+            emitter.storeWord(REGISTERS, stackPointer, RAX_HOST_REGISTER);
+            emitter.storeWord(REGISTERS, getRegisterOffset(destination), RDX_HOST_REGISTER);
+            Emitter::Label done = emitter.jump();
+
+            emitter.bind(wraps);
+            emitter.bind(indirect);
+            emitter.movRegister64(RDI_HOST_REGISTER, CONTEXT);
+            emitter.movImmediate(RSI_HOST_REGISTER, destination);
+            emitter.callAbsolute(reinterpret_cast<const void*>(popRegisterHelper));
+            emitter.test(RAX_HOST_REGISTER, RAX_HOST_REGISTER);
+            exit.labels.push_back(emitter.jump(NOT_EQUAL_CONDITION));
+
+            emitter.bind(done);
+        }
+    }
+
+    Translator::Translator() : codeBuffer(BUFFER_SIZE) {}
+
+    bool Translator::isAvailable() {
+#ifdef WIRED86_JIT_AVAILABLE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool Translator::execute(Intel8086& cpu, const BasicBlock& block, Mem& memory, unsigned int maxInstructions,
+                             BlockResult& result) {
+        Entry& entry = entries[(block.instructionPointer ^ (block.codeSegment << 4)) & (ENTRY_COUNT - 1)];
+        u32 generation = memory.getGeneration(block.firstAddress, block.lastAddress);
+
+        if(entry.codeSegment != block.codeSegment || entry.instructionPointer != block.instructionPointer ||
+           entry.memoryId != memory.getId() || entry.generation != generation) {
+            entry = Entry(); // Entry belongs to a different (or since modified) block.
+
+            entry.codeSegment = block.codeSegment;
+            entry.instructionPointer = block.instructionPointer;
+            entry.memoryId = memory.getId();
+            entry.generation = generation;
+        }
+
+        if(!entry.code) {
+            if(entry.attempted || ++entry.executions < HOT_THRESHOLD) return false;
+
+            unsigned int count;
+            TranslatedCode code = translate(block, memory, count);
+
+            // Translation may have cleared all entries (should the code buffer have been full) so update afterwards:
+            entry.codeSegment = block.codeSegment;
+            entry.instructionPointer = block.instructionPointer;
+            entry.memoryId = memory.getId();
+            entry.generation = generation;
+            entry.attempted = true;
+            entry.code = code;
+            entry.count = count;
+
+            if(!entry.code) return false;
+        }
+
+        if(maxInstructions < entry.count) return false; // Let the interpreter execute a partial block.
+
+        std::exception_ptr exception;
+
+        Mem::DirectAccess direct = memory.getDirectAccess();
+
+        // The register file is little endian, as is the host, so may be accessed in place:
+        Context context;
+        context.registers = cpu.generalRegisters.getData();
+        context.instructionPointer = block.instructionPointer;
+        context.halted = 0;
+        context.aluOperation = reg::NO_ALU_OPERATION;
+        context.cpu = &cpu;
+        context.memory = &memory;
+        context.blockFirstAddress = block.firstAddress;
+        context.blockLastAddress = block.lastAddress;
+        context.blockGeneration = generation;
+        context.exception = &exception;
+        context.stackBase = cpu.segmentRegisters.getBase(reg::STACK_SEGMENT);
+        context.stackLimit = direct.limit == 0 ? 0 : std::min<AbsAddr>(direct.limit - 1, ABSOLUTE_ADDRESS_MASK);
+        context.memoryData = direct.data;
+        context.regionGenerations = direct.regionGenerations;
+        context.dirtyPages = direct.dirtyPages;
+        context.writeCount = direct.writeCount;
+
+        u32 executed = entry.code(&context);
+        nativeExecutionCount++;
+
+        cpu.performRelativeJump(context.instructionPointer);
+        if(context.halted) cpu.halted = true;
+
+        if(context.aluOperation != reg::NO_ALU_OPERATION) {
+            cpu.recordAluOperation(static_cast<reg::AluOperation>(context.aluOperation), context.aluWord != 0,
+                                   context.aluDestination, context.aluSource, context.aluResult);
+        }
+
+        if(exception) std::rethrow_exception(exception);
+
+        result.instructionsExecuted = executed;
+        result.success = true;
+        return true;
+    }
+
+    void Translator::clear() {
+        entries.fill(Entry());
+        codeBuffer.reset();
+    }
+
+    unsigned long Translator::getTranslationCount() const {
+        return translationCount;
+    }
+
+    unsigned long Translator::getNativeExecutionCount() const {
+        return nativeExecutionCount;
+    }
+
+    Translator::TranslatedCode Translator::translate(const BasicBlock& block, const Mem& memory, unsigned int& count) {
+        Emitter emitter;
+        std::vector<HelperExit> helperExits;
+
+        emitter.push(CONTEXT);
+        emitter.push(REGISTERS);
+        emitter.subRspImmediate(8); // Keep the stack 16-byte aligned for calls to helper functions.
+        emitter.movRegister64(CONTEXT, RDI_HOST_REGISTER);
+        emitter.load64(REGISTERS, CONTEXT, contextOffset(offsetof(Context, registers)));
+
+        OffsetAddr ip = block.instructionPointer;
+        count = 0;
+
+        for(unsigned int i = 0; i < block.count; i++) {
+            const instr::DecodedInstruction& instruction = block.instructions[i];
+            OffsetAddr nextIp = ip + instruction.length;
+
+            // Leave the interpreter to report an invalid instruction pointer:
+            if(memory.getAccessMode() == Mem::CHECKED_ACCESS && !memory.withinBounds(nextIp)) break;
+
+            instr::AluFunction function = instr::getEncodedAluFunction(instruction.opcode);
+
+            if(instr::isEGRegisterHandler(instruction.handler) && isTranslatable(function)) {
+                instr::DataSize size = instr::Opcode(instruction.opcode).getDataSize();
+
+                instr::ModRegRm modRegRm(instruction.modRegRm);
+                u8 reg = getRegisterOffset(modRegRm.getRegisterIndexFromReg(size),
+                                           modRegRm.getRegisterPartFromReg(size));
+                u8 rm = getRegisterOffset(modRegRm.getRegisterIndexFromRm(size), modRegRm.getRegisterPartFromRm(size));
+
+                bool regIsSource = instr::Opcode(instruction.opcode).getDirection() == instr::REG_IS_SOURCE;
+                u8 source = regIsSource ? reg : rm;
+                u8 destination = regIsSource ? rm : reg;
+
+                // Operands are zero-extended into EAX (source) and ECX (destination) and recorded for the flags:
+                if(size == instr::WORD_DATA_SIZE) {
+                    emitter.loadZeroExtendedWord(RAX_HOST_REGISTER, REGISTERS, source);
+                    emitter.loadZeroExtendedWord(RCX_HOST_REGISTER, REGISTERS, destination);
+                }
+                else {
+                    emitter.loadZeroExtendedByte(RAX_HOST_REGISTER, REGISTERS, source);
+                    emitter.loadZeroExtendedByte(RCX_HOST_REGISTER, REGISTERS, destination);
+                }
+
+                emitter.storeWord(CONTEXT, contextOffset(offsetof(Context, aluSource)), RAX_HOST_REGISTER);
+                emitter.storeWord(CONTEXT, contextOffset(offsetof(Context, aluDestination)), RCX_HOST_REGISTER);
+
+                // Host and guest encode these functions identically (CMP is performed as a SUB that is not stored):
+                u8 hostFunction = function == instr::CMP_FUNCTION ? instr::SUB_FUNCTION : function;
+
+                if(size == instr::WORD_DATA_SIZE) {
+                    emitter.aluWord(hostFunction, RCX_HOST_REGISTER, RAX_HOST_REGISTER);
+                    if(instr::writesResult(function)) emitter.storeWord(REGISTERS, destination, RCX_HOST_REGISTER);
+                }
+                else {
+                    emitter.aluByte(hostFunction, RCX_HOST_REGISTER, RAX_HOST_REGISTER);
+                    if(instr::writesResult(function)) emitter.storeByte(REGISTERS, destination, RCX_HOST_REGISTER);
+                }
+
+                emitter.storeWord(CONTEXT, contextOffset(offsetof(Context, aluResult)), RCX_HOST_REGISTER);
+                emitter.storeByteImmediate(CONTEXT, contextOffset(offsetof(Context, aluOperation)),
+                                           instr::getFlagOperation(function));
+                emitter.storeByteImmediate(CONTEXT, contextOffset(offsetof(Context, aluWord)),
+                                           size == instr::WORD_DATA_SIZE ? 1 : 0);
+            }
+            else if(instruction.handler == instr::PUSH_REGISTER_HANDLER ||
+                    instruction.handler == instr::POP_REGISTER_HANDLER) {
+                HelperExit exit = { {}, ip, nextIp, count };
+                reg::GeneralRegister stackRegister = instr::getEncodedWordRegister(instruction.opcode);
+
+                if(instruction.handler == instr::PUSH_REGISTER_HANDLER) emitPush(emitter, stackRegister, exit);
+                else emitPop(emitter, stackRegister, exit);
+
+                helperExits.push_back(exit);
+            }
+            else if(instruction.handler == instr::HALT_HANDLER)
+                emitter.storeByteImmediate(CONTEXT, contextOffset(offsetof(Context, halted)), 1);
+            else break; // Instruction not supported so leave the remainder of the block to the interpreter.
+
+            count++;
+            ip = nextIp;
+        }
+
+        if(count == 0) return nullptr;
+
+        emitExit(emitter, ip, count);
+
+        // Exits taken when a helper function indicates that the block must be left early:
+        for(const HelperExit& exit : helperExits) {
+            for(Emitter::Label label : exit.labels) emitter.bind(label);
+
+            emitter.aluImmediate8(instr::CMP_FUNCTION, RAX_HOST_REGISTER, HELPER_STOP);
+            Emitter::Label fault = emitter.jump(NOT_EQUAL_CONDITION);
+            emitExit(emitter, exit.nextInstructionPointer, exit.index + 1);
+
+            emitter.bind(fault);
+            emitExit(emitter, exit.instructionPointer, exit.index);
+        }
+
+        const void* code = codeBuffer.append(emitter.getCode());
+
+        if(!code) { // Buffer full so discard all existing translations and try again.
+            clear();
+            code = codeBuffer.append(emitter.getCode());
+        }
+
+        if(!code) return nullptr;
+
+        translationCount++;
+        return reinterpret_cast<TranslatedCode>(code);
+    }
+}
@@ -0,0 +1,91 @@
+#include "emu/cpu/reg/lazyflags.hpp"
+
+namespace emu::cpu::reg {
+    constexpr Flag STATUS_FLAGS[] = { CARRY_FLAG, PARITY_FLAG, AUX_CARRY_FLAG, ZERO_FLAG, SIGN_FLAG, OVERFLOW_FLAG };
+
+    bool LazyFlags::get(Flag flag) const {
+        if(pendingOperation != NO_ALU_OPERATION && isStatusFlag(flag)) return calculate(flag);
+
+        return flags.get(flag);
+    }
+
+    void LazyFlags::set(Flag flag, bool value) {
+        materialise();
+        flags.set(flag, value);
+    }
+
+    u16 LazyFlags::getWord() const {
+        if(pendingOperation == NO_ALU_OPERATION) return flags.getWord();
+
+        Flags calculated = flags;
+        for(Flag flag : STATUS_FLAGS) calculated.set(flag, calculate(flag));
+
+        return calculated.getWord();
+    }
+
+    void LazyFlags::setWord(u16 value) {
+        flags.setWord(value);
+        pendingOperation = NO_ALU_OPERATION;
+    }
+
+    AluOperation LazyFlags::getPendingOperation() const {
+        return pendingOperation;
+    }
+
+    bool LazyFlags::isStatusFlag(Flag flag) {
+        constexpr u16 statusFlagBits = getFlagMask(CARRY_FLAG) | getFlagMask(PARITY_FLAG) |
+                                       getFlagMask(AUX_CARRY_FLAG) | getFlagMask(ZERO_FLAG) | getFlagMask(SIGN_FLAG) |
+                                       getFlagMask(OVERFLOW_FLAG);
+
+        return (getFlagMask(flag) & statusFlagBits) != 0;
+    }
+
+    bool LazyFlags::calculate(Flag flag) const {
+        u32 destination = pendingDestination, source = pendingSource, result = pendingResult;
+        u32 signBit = pendingWord ? 0x8000 : 0x80;
+        u32 carry = carryIn && (pendingOperation == ADC_OPERATION || pendingOperation == SBB_OPERATION) ? 1 : 0;
+
+        switch(flag) {
+        case CARRY_FLAG:
+            switch(pendingOperation) {
+            case ADD_OPERATION:
+            case ADC_OPERATION: return destination + source + carry > (signBit << 1) - 1;
+            case SUB_OPERATION:
+            case SBB_OPERATION: return destination < source + carry;
+            default: return false;
+            }
+
+        case OVERFLOW_FLAG:
+            switch(pendingOperation) {
+            case ADD_OPERATION:
+            case ADC_OPERATION: return ((destination ^ result) & (source ^ result) & signBit) != 0;
+            case SUB_OPERATION:
+            case SBB_OPERATION: return ((destination ^ source) & (destination ^ result) & signBit) != 0;
+            default: return false;
+            }
+
+        case AUX_CARRY_FLAG:
+            if(pendingOperation == LOGIC_OPERATION) return false; // Undefined so leave clear.
+            return ((destination ^ source ^ result) & 0x10) != 0;
+
+        case PARITY_FLAG: { // Set when the least significant byte of the result has an even number of set bits.
+            u8 bits = static_cast<u8>(result);
+            bits ^= bits >> 4;
+            bits ^= bits >> 2;
+            bits ^= bits >> 1;
+            return (bits & 1) == 0;
+        }
+
+        case ZERO_FLAG: return result == 0;
+        case SIGN_FLAG: return (result & signBit) != 0;
+
+        default: return flags.get(flag);
+        }
+    }
+
+    void LazyFlags::materialise() {
+        if(pendingOperation == NO_ALU_OPERATION) return;
+
+        setWord(getWord());
+    }
+}
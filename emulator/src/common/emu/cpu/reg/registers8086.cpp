@@ -58,8 +58,4 @@ namespace emu::cpu::reg {
 
         return UNKNOWN_INDEX;
     }
-
-    std::string Flags::getAssemblyIdentifier(Flag) const {
-        return "flags";
-    }
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "emu/hostmemory.hpp"
+
+#include <algorithm>
+#include <new>
+#include "logging.hpp"
+
+#ifdef WIRED86_HOST_MAPPING_AVAILABLE
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace emu {
+#ifdef WIRED86_HOST_MAPPING_AVAILABLE
+    HostMemory::HostMemory(std::size_t bytes) : size(bytes) {
+        std::size_t pageSize = getPageSize();
+        mappedSize = (bytes + pageSize - 1) / pageSize * pageSize;
+
+        void* mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(mapping == MAP_FAILED) throw std::bad_alloc();
+
+        data = static_cast<u8*>(mapping);
+    }
+
+    HostMemory::~HostMemory() {
+        munmap(data, mappedSize); // Also removes any files mapped over the block.
+    }
+
+    bool HostMemory::isMappingAvailable() {
+        return true;
+    }
+
+    void HostMemory::zero() {
+        if(mmap(data, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+            logging::warning("Failed to replace host memory with a fresh mapping so zeroing it directly instead.");
+            std::fill(data, data + size, 0);
+        }
+    }
+
+    std::size_t HostMemory::getPageSize() {
+        static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        return pageSize;
+    }
+
+    std::size_t HostMemory::mapFile(const std::string& path, std::size_t offset, bool readOnly) {
+        std::size_t pageSize = getPageSize();
+        if(offset % pageSize != 0 || offset >= size) return 0;
+
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0) return 0;
+
+        std::size_t length = 0;
+        struct stat status;
+
+        if(fstat(file, &status) == 0 && S_ISREG(status.st_mode)) {
+            std::size_t fileSize = static_cast<std::size_t>(status.st_size);
+            length = std::min(fileSize, size - offset) / pageSize * pageSize; // Whole pages only.
+        }
+
+        int protection = readOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+
+        // A failed fixed mapping may remove the previous mapping of the range regardless (losing its contents), so the
+        // file is first mapped elsewhere to check that it can be mapped at all before the block is touched:
+        void* trial = length > 0 ? mmap(nullptr, length, protection, MAP_PRIVATE, file, 0) : MAP_FAILED;
+
+        if(trial == MAP_FAILED) length = 0;
+        else {
+            munmap(trial, length);
+
+            if(mmap(data + offset, length, protection, MAP_PRIVATE | MAP_FIXED, file, 0) == MAP_FAILED) {
+                logging::error("Failed to map a file over host memory after checking that it could be mapped.");
+
+                if(mmap(data + offset, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+                        -1, 0) == MAP_FAILED) logging::error("Failed to restore host memory after a failed mapping.");
+                length = 0;
+            }
+        }
+
+        close(file);
+        return length;
+    }
+#else
+    HostMemory::HostMemory(std::size_t bytes) : size(bytes), allocation(new u8[bytes]()) {
+        data = allocation.get();
+    }
+
+    HostMemory::~HostMemory() = default;
+
+    bool HostMemory::isMappingAvailable() {
+        return false;
+    }
+
+    void HostMemory::zero() {
+        std::fill(data, data + size, 0);
+    }
+
+    std::size_t HostMemory::getPageSize() {
+        return 4096;
+    }
+
+    std::size_t HostMemory::mapFile(const std::string&, std::size_t, bool) {
+        return 0;
+    }
+#endif
+
+    u8* HostMemory::getData() const {
+        return data;
+    }
+
+    std::size_t HostMemory::getSize() const {
+        return size;
+    }
+}
@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "primitives.hpp"
+#include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/jit/translator.hpp"
+
+/*
+ * Replacements for the global allocation functions. These apply to the entire test executable but allocations are
+ * only counted while explicitly enabled by the test below. Every form is replaced (as all are released by the replaced
+ * operator delete) so that allocation and deallocation always match.
+ */
+namespace {
+    bool countingAllocations = false;
+    unsigned long allocationCount = 0;
+
+    /// Allocate with malloc (or aligned_alloc for alignments beyond that of malloc), returning nullptr on failure.
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) noexcept {
+        if(countingAllocations) allocationCount++;
+        if(size == 0) size = 1;
+
+        if(alignment <= alignof(std::max_align_t)) return std::malloc(size);
+        return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+
+    void* allocateOrThrow(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        void* ptr = allocate(size, alignment);
+        if(!ptr) throw std::bad_alloc();
+
+        return ptr;
+    }
+}
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+TEST_CASE("Test that execution does not allocate once warmed up.", "[emu][cpu][allocation]") {
+    using namespace emu;
+
+    Mem memory(0xFF);
+
+    cpu::Intel8086 cpu;
+
+    // push ax, push bx, add ax, bx, xor cl, ch, add [si], ax, sub dx, [bp+di+0x4], pop cx, pop dx, hlt
+    memory.write(0, { 0x50, 0x53, 0x01, 0xD8, 0x30, 0xE9, 0x01, 0x04, 0x2B, 0x53, 0x04, 0x59, 0x5A, 0xF4 });
+
+    cpu.generalRegisters.set(cpu::reg::STACK_POINTER, 0xAA);
+    cpu.generalRegisters.set(cpu::reg::SOURCE_INDEX, 0x80);
+    cpu.generalRegisters.set(cpu::reg::BASE_POINTER, 0x40);
+    cpu.addBreakpoint(0xF0); // Never reached but ensures breakpoints are checked.
+
+    auto runProgram = [&](unsigned int times) {
+        for(unsigned int i = 0; i < times; i++) {
+            cpu.halted = false;
+            cpu.performRelativeJump(0);
+            cpu.run(memory, 1000);
+        }
+    };
+
+    auto countAllocations = [&](unsigned int times) {
+        allocationCount = 0;
+        countingAllocations = true;
+
+        runProgram(times);
+
+        countingAllocations = false;
+        return allocationCount;
+    };
+
+    SECTION("Test the interpreter.") {
+        runProgram(100); // Warm up.
+
+        REQUIRE(countAllocations(10000) == 0);
+    }
+
+    SECTION("Test translated code.") {
+        if(!cpu.setJitEnabled(true)) return;
+
+        runProgram(100);
+        REQUIRE(cpu.getTranslator()->getTranslationCount() > 0);
+
+        REQUIRE(countAllocations(10000) == 0);
+    }
+}
@@ -1,6 +1,9 @@
 #include "catch.hpp"
+#include <optional>
 #include "primitives.hpp"
+#include "cpustate.hpp"
 #include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/instr/effectiveaddress.hpp"
 
 TEST_CASE("Test CPU instruction execution.", "[emu][cpu][instructions]") {
     using namespace emu;
@@ -12,6 +15,45 @@ TEST_CASE("Test CPU instruction execution.", "[emu][cpu][instructions]") {
     cpu.generalRegisters.set(cpu::reg::STACK_POINTER, 0xAA);
     cpu.segmentRegisters.set(cpu::reg::STACK_SEGMENT, 0);
 
+    SECTION("Test register file byte aliasing.") {
+        auto& registers = cpu.generalRegisters;
+
+        registers.set(cpu::reg::CX_REGISTER, 0x1234);
+        REQUIRE(registers.get(cpu::reg::CX_REGISTER, cpu::reg::LOW_BYTE) == 0x34);
+        REQUIRE(registers.get(cpu::reg::CX_REGISTER, cpu::reg::HIGH_BYTE) == 0x12);
+
+        registers.set(cpu::reg::CX_REGISTER, cpu::reg::HIGH_BYTE, 0xAB);
+        registers.setLow(cpu::reg::CX_REGISTER, 0xCD);
+        REQUIRE(registers.get(cpu::reg::CX_REGISTER) == 0xABCD);
+        REQUIRE(registers.get(cpu::reg::DX_REGISTER) == 0); // Neighbouring registers unaffected.
+
+        auto offset = cpu::reg::GeneralRegisters::getByteOffset(cpu::reg::CX_REGISTER, cpu::reg::HIGH_BYTE);
+        REQUIRE(registers.getBytes()[offset] == 0xAB);
+    }
+
+    SECTION("Test segmented address resolution.") {
+        cpu.segmentRegisters.set(cpu::reg::DATA_SEGMENT, 0x1234);
+        REQUIRE(cpu.segmentRegisters.getBase(cpu::reg::DATA_SEGMENT) == 0x12340);
+        REQUIRE(cpu.resolveAddress(0x0010, cpu::reg::DATA_SEGMENT) == 0x12350);
+
+        cpu.segmentRegisters.set(cpu::reg::EXTRA_SEGMENT, 0xFFFF);
+        REQUIRE(cpu.resolveAddress(0x000F, cpu::reg::EXTRA_SEGMENT) == 0xFFFFF);
+        REQUIRE(cpu.resolveAddress(0x0020, cpu::reg::EXTRA_SEGMENT) == 0x00010); // Wraps around at 1 MiB.
+    }
+
+    SECTION("Test memory accesses beyond the end of memory.") {
+        memory.setAccessMode(Mem::WRAPPED_ACCESS, ABSOLUTE_ADDRESS_MASK);
+
+        memory.write(0, { 0x01, 0x04, 0xF4 }); // add [si], ax, hlt
+        cpu.generalRegisters.set(cpu::reg::SOURCE_INDEX, 0x1000);
+
+        auto result = cpu.run(memory, 10);
+        REQUIRE(result.reason == cpu::HALTED_STOP);
+        REQUIRE(result.instructionsRetired == 2);
+        REQUIRE(memory.getFaultCount() > 0);
+        REQUIRE(memory.getLastFaultAddress() >= memory.size);
+    }
+
     SECTION("Test CPU stack handling.") {
         cpu.pushToStack(0xAB, memory);
         cpu.pushToStack(0xCD, memory);
@@ -22,7 +64,35 @@ TEST_CASE("Test CPU instruction execution.", "[emu][cpu][instructions]") {
         REQUIRE(cpu.popFromStack(memory) == 0xAB);
 
         cpu.pushWordToStack(0xABCD, memory);
+        REQUIRE(memory.read(0xA8) == 0xCD);
+        REQUIRE(memory.read(0xA9) == 0xAB);
         REQUIRE(cpu.popWordFromStack(memory) == 0xABCD);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 0xAA);
+
+        // The stack pointer wraps around within the stack segment:
+        Mem segmentMemory(0x20000);
+        cpu.segmentRegisters.set(cpu::reg::STACK_SEGMENT, 0x1000);
+
+        cpu.generalRegisters.set(cpu::reg::STACK_POINTER, 0);
+        cpu.pushWordToStack(0x1234, segmentMemory);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 0xFFFE);
+        REQUIRE(segmentMemory.read(0x1FFFE) == 0x34);
+        REQUIRE(segmentMemory.read(0x1FFFF) == 0x12);
+        REQUIRE(cpu.popWordFromStack(segmentMemory) == 0x1234);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 0);
+
+        cpu.generalRegisters.set(cpu::reg::STACK_POINTER, 1);
+        cpu.pushWordToStack(0x5678, segmentMemory); // Word straddles the end of the segment.
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 0xFFFF);
+        REQUIRE(segmentMemory.read(0x1FFFF) == 0x78);
+        REQUIRE(segmentMemory.read(0x10000) == 0x56);
+        REQUIRE(cpu.popWordFromStack(segmentMemory) == 0x5678);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 1);
+
+        // Failed pushes leave the stack pointer unchanged:
+        cpu.segmentRegisters.set(cpu::reg::STACK_SEGMENT, 0x2000);
+        REQUIRE_THROWS_AS(cpu.pushWordToStack(0x9ABC, segmentMemory), Mem::OutOfBounds);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 1);
     }
 
     SECTION("Test stack instructions.") {
@@ -33,14 +103,14 @@ TEST_CASE("Test CPU instruction execution.", "[emu][cpu][instructions]") {
             // Push value in register to stack:
             memory.write(0, pushOpcode);
             auto push = cpu.fetchDecodeInstruction(0, memory);
-            cpu.executeInstruction(push, memory);
+            cpu.executeInstruction(*push, memory);
 
             cpu.generalRegisters.set(reg, 0); // Reset register value.
 
             // Pop value off stack back into register:
             memory.write(1, popOpcode);
             auto pop = cpu.fetchDecodeInstruction(1, memory);
-            cpu.executeInstruction(pop, memory);
+            cpu.executeInstruction(*pop, memory);
 
             REQUIRE(value == cpu.generalRegisters.get(reg)); // Assert that the instructions functioned correctly.
         };
@@ -64,10 +134,449 @@ TEST_CASE("Test CPU instruction execution.", "[emu][cpu][instructions]") {
         memory.write(0, { 0b00000001, 0b11011001 }); // add cx, bx
         
         auto add = cpu.fetchDecodeInstruction(0, memory);
-        cpu.executeInstruction(add, memory);
+        cpu.executeInstruction(*add, memory);
 
         REQUIRE(add->toAssembly(cpu, assembly::Style()) == "add cx, bx");
         REQUIRE(cpu.generalRegisters.get(cpu::reg::CX_REGISTER) == 15);
 
     }
-}
\ No newline at end of file
+
+    SECTION("Test lazily evaluated flags.") {
+        using namespace cpu::reg;
+
+        auto requireFlags = [&cpu](bool carry, bool parity, bool auxCarry, bool zero, bool sign, bool overflow) {
+            REQUIRE(cpu.getFlag(CARRY_FLAG) == carry);
+            REQUIRE(cpu.getFlag(PARITY_FLAG) == parity);
+            REQUIRE(cpu.getFlag(AUX_CARRY_FLAG) == auxCarry);
+            REQUIRE(cpu.getFlag(ZERO_FLAG) == zero);
+            REQUIRE(cpu.getFlag(SIGN_FLAG) == sign);
+            REQUIRE(cpu.getFlag(OVERFLOW_FLAG) == overflow);
+        };
+
+        cpu.generalRegisters.set(AX_REGISTER, 0x7F80);
+        cpu.generalRegisters.set(BX_REGISTER, 0x0180);
+
+        memory.write(0, { 0b00000000, 0b11011000 }); // add al, bl (0x80 + 0x80)
+        cpu.executeInstruction(*cpu.fetchDecodeInstruction(0, memory), memory);
+        requireFlags(true, true, false, true, false, true);
+
+        memory.write(0, { 0b00000001, 0b11011000 }); // add ax, bx (0x7F00 + 0x0180)
+        cpu.performRelativeJump(0);
+        cpu.executeInstruction(*cpu.fetchDecodeInstruction(0, memory), memory);
+        REQUIRE(cpu.generalRegisters.get(AX_REGISTER) == 0x8080);
+        requireFlags(false, false, false, false, true, true);
+
+        // Explicitly set flags are retained alongside those calculated from the last operation:
+        cpu.setFlag(DIRECTION_FLAG, true);
+        cpu.setFlag(CARRY_FLAG, true);
+        requireFlags(true, false, false, false, true, true);
+        REQUIRE(cpu.getFlag(DIRECTION_FLAG));
+
+        cpu.recordAluOperation(SUB_OPERATION, false, 0x10, 0x20, 0x10 - 0x20);
+        requireFlags(true, true, false, false, true, false);
+
+        cpu.recordAluOperation(SBB_OPERATION, true, 0x8000, 0x0001, 0x8000 - 0x0001 - 1); // Borrows the carry.
+        requireFlags(false, false, true, false, false, true);
+
+        cpu.recordAluOperation(LOGIC_OPERATION, true, 0xFF00, 0x0F0F, 0xFF00 & 0x0F0F);
+        requireFlags(false, true, false, false, false, false);
+        REQUIRE(cpu.getFlag(DIRECTION_FLAG));
+    }
+
+    SECTION("Test FLAGS register transfer instructions.") {
+        using namespace cpu::reg;
+
+        auto runFrom = [&](std::initializer_list<u8> program) {
+            memory.write(0, program);
+            cpu.halted = false;
+            cpu.performRelativeJump(0);
+            cpu.run(memory, 10);
+        };
+
+        cpu.generalRegisters.set(AX_REGISTER, 0x0080);
+        cpu.generalRegisters.set(BX_REGISTER, 0x0080);
+        cpu.setFlag(DIRECTION_FLAG, true);
+
+        runFrom({ 0x00, 0xD8, 0x9C, 0x9F, 0xF4 }); // add al, bl, pushf, lahf, hlt
+
+        // CF, PF, ZF and OF calculated from the addition, DF set explicitly and the reserved bits always set:
+        u16 expected = 0xF002 | getFlagMask(CARRY_FLAG) | getFlagMask(PARITY_FLAG) | getFlagMask(ZERO_FLAG) |
+                       getFlagMask(DIRECTION_FLAG) | getFlagMask(OVERFLOW_FLAG);
+
+        REQUIRE(cpu.getFlagsWord() == expected);
+        REQUIRE(cpu.generalRegisters.getHigh(AX_REGISTER) == (expected & 0xFF));
+        REQUIRE(memory.read(0xA8) == (expected & 0xFF));
+        REQUIRE(memory.read(0xA9) == expected >> 8);
+
+        cpu.generalRegisters.setHigh(AX_REGISTER, getFlagMask(SIGN_FLAG));
+        runFrom({ 0x9E, 0xF4 }); // sahf, hlt
+
+        REQUIRE(cpu.getFlag(SIGN_FLAG));
+        REQUIRE_FALSE(cpu.getFlag(CARRY_FLAG));
+        REQUIRE_FALSE(cpu.getFlag(ZERO_FLAG));
+        REQUIRE(cpu.getFlag(OVERFLOW_FLAG)); // Not held in the low byte so unaffected.
+        REQUIRE(cpu.getFlag(DIRECTION_FLAG));
+
+        runFrom({ 0x9D, 0xF4 }); // popf, hlt
+
+        REQUIRE(cpu.getFlagsWord() == expected);
+        REQUIRE(cpu.generalRegisters.get(STACK_POINTER) == 0xAA);
+
+        REQUIRE(cpu.fetchDecodeInstruction(0, memory)->toAssembly(cpu, assembly::Style()) == "popf");
+    }
+
+    SECTION("Test decoded instruction views and reference execution.") {
+        memory.write(0, { 0b00000001, 0b11011001 }); // add cx, bx
+
+        auto decoded = cpu.fetchDecodeInstruction(0, memory);
+        auto object = decoded->toInstruction();
+
+        std::vector<u8> expected = { 0b00000001, 0b11011001 };
+        REQUIRE(decoded->getRawData() == expected);
+        REQUIRE(object->getRawData() == expected);
+        REQUIRE(object->toAssembly(cpu, assembly::Style()) == decoded->toAssembly(cpu, assembly::Style()));
+
+        // Executing via the handler and via the virtual instruction object should have identical results:
+        cpu.generalRegisters.set(cpu::reg::CX_REGISTER, 1);
+        cpu.generalRegisters.set(cpu::reg::BX_REGISTER, 2);
+        cpu.executeInstruction(*decoded, memory);
+        cpu.executeInstruction(*object, memory);
+
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::CX_REGISTER) == 5);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 4);
+    }
+
+    SECTION("Test caching of decoded instructions.") {
+        memory.write(0, 0x50); // push ax
+
+        cpu.fetchDecodeInstruction(0, memory);
+        cpu.fetchDecodeInstruction(0, memory);
+
+        REQUIRE(cpu.getDecodeCache().getHits() == 1); // Second fetch served from cache.
+        REQUIRE(cpu.getDecodeCache().getMisses() == 1);
+
+        memory.write(0, 0x58); // Overwrite with pop ax so that the cached instruction is no longer valid.
+
+        auto third = cpu.fetchDecodeInstruction(0, memory);
+
+        REQUIRE(third->toAssembly(cpu, assembly::Style()) == "pop ax");
+        REQUIRE(cpu.getDecodeCache().getMisses() == 2);
+
+        // Memory constructed in place of destroyed memory has the same address and generations but a different id:
+        std::optional<Mem> reused(std::in_place, 0xFF);
+        reused->write(0, 0x50); // push ax
+        cpu.fetchDecodeInstruction(0, *reused);
+
+        reused.emplace(0xFF);
+        reused->write(0, 0x58); // pop ax
+        REQUIRE(cpu.fetchDecodeInstruction(0, *reused)->toAssembly(cpu, assembly::Style()) == "pop ax");
+    }
+
+    SECTION("Test instruction fetch at the end of memory and the code segment.") {
+        memory.write(0xFE, 0b00000001); // add with its MOD-REG-R/M byte beyond the end of memory.
+        REQUIRE_THROWS_AS(cpu.fetchDecodeInstruction(0xFE, memory), Mem::OutOfBounds);
+
+        Mem segmentMemory(0x10000);
+
+        // add ax, bx straddling the end of the code segment followed by hlt at its start:
+        segmentMemory.write(0xFFFF, 0b00000001);
+        segmentMemory.write(0x0000, { 0b11011000, 0xF4 });
+
+        cpu.generalRegisters.set(cpu::reg::AX_REGISTER, 2);
+        cpu.generalRegisters.set(cpu::reg::BX_REGISTER, 5);
+        cpu.performRelativeJump(0xFFFF);
+
+        auto result = cpu.run(segmentMemory, 100);
+        REQUIRE(result.reason == cpu::HALTED_STOP);
+        REQUIRE(result.instructionsRetired == 2);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::AX_REGISTER) == 7);
+
+        // Modifying the wrapped part of the instruction must invalidate the block:
+        segmentMemory.write(0x0000, 0b11000000); // add ax, ax
+        cpu.halted = false;
+        cpu.performRelativeJump(0xFFFF);
+        cpu.run(segmentMemory, 1);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::AX_REGISTER) == 14);
+    }
+
+    SECTION("Test block-at-a-time execution.") {
+        // push ax, pop bx, add cx, bx, hlt
+        memory.write(0x10, { 0x50, 0x5B, 0b00000001, 0b11011001, 0xF4 });
+
+        cpu.generalRegisters.set(cpu::reg::AX_REGISTER, 3);
+        cpu.generalRegisters.set(cpu::reg::CX_REGISTER, 4);
+        cpu.performRelativeJump(0x10);
+
+        auto result = cpu.executeBlock(memory);
+
+        REQUIRE(result.success);
+        REQUIRE(result.instructionsExecuted == 4);
+        REQUIRE(cpu.halted);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::CX_REGISTER) == 7);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 0x15);
+
+        REQUIRE_FALSE(cpu.executeBlock(memory).success); // Halted CPU cannot execute further blocks.
+
+        // Executing the same block again should hit the cache, unless its memory has since been modified:
+        cpu.halted = false;
+        cpu.performRelativeJump(0x10);
+        cpu.executeBlock(memory, 2);
+        REQUIRE(cpu.getBlockCache().getHits() == 1);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 0x12);
+
+        memory.write(0x10, 0x53); // push bx
+        cpu.performRelativeJump(0x10);
+        cpu.executeBlock(memory);
+        REQUIRE(cpu.getBlockCache().getHits() == 1);
+        REQUIRE(cpu.getBlockCache().getMisses() == 2);
+
+        // Blocks must not be reused for memory constructed in place of the memory they were decoded from:
+        std::optional<Mem> reused(std::in_place, 0xFF);
+        reused->write(0x10, 0x50); // push ax
+        cpu.halted = false;
+        cpu.performRelativeJump(0x10);
+        cpu.executeBlock(*reused, 1);
+
+        reused.emplace(0xFF);
+        reused->write(0x10, 0xF4); // hlt
+        cpu.performRelativeJump(0x10);
+        cpu.executeBlock(*reused, 1);
+        REQUIRE(cpu.halted);
+    }
+
+    SECTION("Test batch execution with stop reasons.") {
+        // push ax, pop bx, add cx, bx, add cx, bx, hlt
+        memory.write(0x10, { 0x50, 0x5B, 0b00000001, 0b11011001, 0b00000001, 0b11011001, 0xF4 });
+
+        cpu.generalRegisters.set(cpu::reg::AX_REGISTER, 3);
+        cpu.performRelativeJump(0x10);
+
+        auto result = cpu.run(memory, 2);
+        REQUIRE(result.reason == cpu::BUDGET_STOP);
+        REQUIRE(result.instructionsRetired == 2);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 0x12);
+
+        cpu.addBreakpoint(0x14); // Second add.
+        result = cpu.run(memory, 100);
+        REQUIRE(result.reason == cpu::BREAKPOINT_STOP);
+        REQUIRE(result.instructionsRetired == 1);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 0x14);
+
+        result = cpu.run(memory, 100); // Resume from the breakpoint.
+        REQUIRE(result.reason == cpu::HALTED_STOP);
+        REQUIRE(result.instructionsRetired == 2);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::CX_REGISTER) == 6);
+
+        REQUIRE(cpu.run(memory, 100).reason == cpu::HALTED_STOP);
+
+        cpu.removeBreakpoint(0x14);
+        REQUIRE_FALSE(cpu.hasBreakpoint(0x14));
+
+        cpu.halted = false;
+        cpu.performRelativeJump(0x40);
+        memory.write(0x40, 0x0F); // Unimplemented opcode.
+        result = cpu.run(memory, 100);
+        REQUIRE(result.reason == cpu::DECODE_FAILURE_STOP);
+        REQUIRE(result.instructionsRetired == 0);
+    }
+
+    SECTION("Test fused instruction pairs.") {
+        // push ax, push bx, pop cx, pop dx, push cx, pop si, hlt
+        std::vector<MemValue> program = { 0x50, 0x53, 0x59, 0x5A, 0x51, 0x5E, 0xF4 };
+        memory.write(0x10, program);
+
+        Mem unfusedMemory(0xFF);
+        unfusedMemory.write(0x10, program);
+
+        cpu::Intel8086 unfused;
+        for(auto pair : { cpu::instr::PUSH_PUSH_PAIR, cpu::instr::POP_POP_PAIR, cpu::instr::PUSH_POP_PAIR })
+            unfused.setPairFusion(pair, false);
+
+        for(auto* c : { &cpu, &unfused }) {
+            c->generalRegisters.set(cpu::reg::STACK_POINTER, 0xAA);
+            c->generalRegisters.set(cpu::reg::AX_REGISTER, 0x1234);
+            c->generalRegisters.set(cpu::reg::BX_REGISTER, 0x5678);
+            c->performRelativeJump(0x10);
+        }
+
+        REQUIRE(cpu.run(memory, 100).instructionsRetired == 7);
+        REQUIRE(unfused.run(unfusedMemory, 100).instructionsRetired == 7);
+
+        for(auto reg : { cpu::reg::AX_REGISTER, cpu::reg::BX_REGISTER, cpu::reg::CX_REGISTER, cpu::reg::DX_REGISTER,
+                         cpu::reg::STACK_POINTER, cpu::reg::SOURCE_INDEX })
+            REQUIRE(cpu.generalRegisters.get(reg) == unfused.generalRegisters.get(reg));
+
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::SOURCE_INDEX) == 0x5678);
+        REQUIRE(memory.read(0, memory.size) == unfusedMemory.read(0, unfusedMemory.size));
+        REQUIRE(cpu.getFusedPairExecutions() == 3);
+        REQUIRE(unfused.getFusedPairExecutions() == 0);
+
+        // Breakpoints and single steps within a pair execute only its first instruction:
+        cpu.halted = false;
+        cpu.generalRegisters.set(cpu::reg::STACK_POINTER, 0xAA);
+        cpu.performRelativeJump(0x10);
+        cpu.addBreakpoint(0x11);
+
+        auto result = cpu.run(memory, 100);
+        REQUIRE(result.reason == cpu::BREAKPOINT_STOP);
+        REQUIRE(result.instructionsRetired == 1);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 0x11);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 0xA8);
+
+        REQUIRE(cpu.executeBlock(memory, 1).instructionsExecuted == 1);
+        REQUIRE(cpu.getRelativeInstructionPointer() == 0x12);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::STACK_POINTER) == 0xA6);
+        REQUIRE(cpu.getFusedPairExecutions() == 3);
+
+        // A push that overwrites the second instruction of its pair, making it pop cx followed by hlt:
+        cpu.clearBreakpoints();
+        cpu.halted = false;
+        memory.write(0x10, { 0x50, 0x5B, 0x00 }); // push ax, pop bx
+        cpu.generalRegisters.set(cpu::reg::AX_REGISTER, 0xF459);
+        cpu.generalRegisters.set(cpu::reg::BX_REGISTER, 0);
+        cpu.generalRegisters.set(cpu::reg::STACK_POINTER, 0x13);
+        cpu.performRelativeJump(0x10);
+
+        REQUIRE(cpu.run(memory, 100).reason == cpu::HALTED_STOP);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::BX_REGISTER) == 0);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::CX_REGISTER) == 0xF459);
+    }
+
+    SECTION("Test E, G arithmetic/logic handlers against the reference instruction objects.") {
+        Mem referenceMemory(0xFF);
+        cpu::Intel8086 reference;
+
+        std::vector<MemValue> program;
+
+        for(u8 opcode = 0x00; opcode < 0x40; opcode++) {
+            if((opcode & 0b111) > 0b011) continue; // Not an E, G opcode.
+
+            program.push_back(opcode);
+            program.push_back(static_cast<u8>(0b11000000 | ((opcode * 5) & 0b111111))); // Register addressing mode.
+        }
+
+        program.push_back(0xF4); // hlt
+
+        test::initialiseRegisters(cpu);
+        test::initialiseRegisters(reference);
+
+        memory.write(0, program);
+        referenceMemory.write(0, program);
+
+        while(!cpu.halted) {
+            REQUIRE(cpu.executeInstruction(*cpu.fetchDecodeInstruction(cpu.getAbsoluteInstructionPointer(), memory),
+                                           memory));
+            test::executeReferenceInstruction(reference, referenceMemory);
+
+            test::requireSameState(cpu, reference);
+        }
+
+        // Spot check some results against values calculated by hand:
+        cpu.generalRegisters.set(cpu::reg::AX_REGISTER, 0x00F0);
+        cpu.generalRegisters.set(cpu::reg::BX_REGISTER, 0x0F0F);
+        cpu.halted = false;
+
+        memory.write(0, { 0x30, 0xD8, 0x38, 0xC4, 0x29, 0xD8, 0xF4 }); // xor al, bl; cmp ah, al; sub ax, bx
+        cpu.performRelativeJump(0);
+        while(!cpu.halted) REQUIRE(cpu.executeBlock(memory).success);
+
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::AX_REGISTER) == static_cast<u16>(0x00FF - 0x0F0F));
+        REQUIRE(cpu.getFlag(cpu::reg::CARRY_FLAG));
+        REQUIRE(cpu.getFlag(cpu::reg::SIGN_FLAG));
+    }
+
+    SECTION("Test E, G handlers with memory operands against the reference instruction objects.") {
+        // Data is addressed in a separate 64K segment to the code so that every possible offset is valid:
+        Mem largeMemory(0x20000), referenceMemory(0x20000);
+        cpu::Intel8086 reference;
+
+        std::vector<MemValue> program;
+
+        for(unsigned int mode = 0; mode < cpu::instr::EFFECTIVE_ADDRESS_MODE_COUNT; mode++) {
+            for(u8 opcode = 0x00; opcode < 0x40; opcode++) {
+                if((opcode & 0b111) > 0b011 || (opcode + mode) % 5 != 0) continue; // Not an E, G opcode or skipped.
+
+                u8 mod = static_cast<u8>(mode / 8), rm = static_cast<u8>(mode % 8);
+                u8 modRegRm = static_cast<u8>(mod << 6 | (opcode & 0b111000) | rm);
+
+                program.push_back(opcode);
+                program.push_back(modRegRm);
+
+                if(mod == 0b01) program.push_back(static_cast<u8>(opcode * 7)); // Byte displacement (may be negative).
+                if(mod == 0b10 || (mod == 0b00 && rm == 0b110)) {
+                    program.push_back(static_cast<u8>(opcode * 13));
+                    program.push_back(static_cast<u8>(0xFF - opcode));
+                }
+            }
+        }
+
+        program.push_back(0xF4); // hlt
+
+        for(auto* c : { &cpu, &reference }) {
+            test::initialiseRegisters(*c);
+            c->generalRegisters.set(cpu::reg::BASE_POINTER, 0x0101);
+            c->segmentRegisters.set(cpu::reg::DATA_SEGMENT, 0x1000);
+            c->segmentRegisters.set(cpu::reg::STACK_SEGMENT, 0x1000);
+        }
+
+        for(AbsAddr address = 0x10000; address < 0x20000; address += 3) {
+            largeMemory.write(address, static_cast<u8>(address * 31));
+            referenceMemory.write(address, static_cast<u8>(address * 31));
+        }
+
+        largeMemory.write(0, program);
+        referenceMemory.write(0, program);
+
+        while(!cpu.halted) {
+            REQUIRE(cpu.executeInstruction(*cpu.fetchDecodeInstruction(cpu.getAbsoluteInstructionPointer(),
+                                                                       largeMemory), largeMemory));
+            test::executeReferenceInstruction(reference, referenceMemory);
+
+            test::requireSameState(cpu, reference);
+        }
+
+        REQUIRE(largeMemory.read(0x10000, 0x10000) == referenceMemory.read(0x10000, 0x10000));
+
+        // Spot check addressing against values calculated by hand (BP-based modes default to the stack segment):
+        cpu.segmentRegisters.set(cpu::reg::DATA_SEGMENT, 0x1);
+        cpu.segmentRegisters.set(cpu::reg::STACK_SEGMENT, 0x2);
+        cpu.generalRegisters.set(cpu::reg::AX_REGISTER, 0x0305);
+        cpu.generalRegisters.set(cpu::reg::BX_REGISTER, 0x0004);
+        cpu.generalRegisters.set(cpu::reg::SOURCE_INDEX, 0x0002);
+        cpu.generalRegisters.set(cpu::reg::BASE_POINTER, 0x0001);
+        cpu.halted = false;
+
+        // add [bp+si], al; add [bx+si-1], ah; add [0x0030], ax; add cx, [bp+0x2e]; hlt
+        memory.write(0x80, { 0x00, 0x02, 0x00, 0x60, 0xFF, 0x01, 0x06, 0x30, 0x00, 0x03, 0x4E, 0x2E, 0xF4 });
+        cpu.generalRegisters.set(cpu::reg::CX_REGISTER, 0);
+        cpu.performRelativeJump(0x80);
+        while(!cpu.halted) REQUIRE(cpu.executeBlock(memory).success);
+
+        REQUIRE(memory.read(0x23) == 0x05); // SS:0003
+        REQUIRE(memory.read(0x15) == 0x03); // DS:0005
+        REQUIRE(memory.read(0x40) == 0x05); // DS:0030
+        REQUIRE(memory.read(0x41) == 0x03);
+        REQUIRE(cpu.generalRegisters.get(cpu::reg::CX_REGISTER) == convert::createWordFromBytes(memory.read(0x4F),
+                                                                                                memory.read(0x50)));
+    }
+
+    SECTION("Test block execution against the reference instruction objects.") {
+        // push ax, push bx, add ax, bx, add cl, ch, add dh, bl, pop cx, pop dx, add [si], ax, hlt
+        std::vector<MemValue> program = { 0x50, 0x53, 0x01, 0xD8, 0x00, 0xE9, 0x02, 0xF3, 0x59, 0x5A, 0x01, 0x04, 0xF4 };
+
+        Mem referenceMemory(0xFF);
+        cpu::Intel8086 reference;
+
+        test::initialiseRegisters(cpu);
+        test::initialiseRegisters(reference);
+
+        memory.write(0, program);
+        referenceMemory.write(0, program);
+
+        while(!cpu.halted) REQUIRE(cpu.executeBlock(memory).success);
+        while(!reference.halted) test::executeReferenceInstruction(reference, referenceMemory);
+
+        test::requireSameState(cpu, reference);
+        REQUIRE(memory.read(0, memory.size) == referenceMemory.read(0, referenceMemory.size));
+    }
+}
@@ -1,5 +1,92 @@
 #include "catch.hpp"
 #include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/instr/opcodetable.hpp"
+
+namespace {
+    using namespace emu::cpu;
+    using namespace emu::cpu::instr;
+
+    /// Properties of a MOD-REG-R/M byte as worked out by hand from the 8086 manual.
+    struct ExpectedModRegRm {
+        u8 value;
+        AddressingMode mode;
+        u8 displacementReadLength;
+        DisplacementType displacementType; /// Not meaningful in register addressing mode so not checked.
+        bool displacementUsed;
+        reg::GeneralRegister wordReg, byteReg;
+        reg::RegisterPart byteRegPart;
+        reg::GeneralRegister wordRm, byteRm;
+        reg::RegisterPart byteRmPart;
+    };
+
+    constexpr ExpectedModRegRm EXPECTED_MODREGRMS[] = {
+        // [bx+si], ax/al:
+        { 0x00, NO_DISPLACEMENT, 0, BX_SI_DISPLACEMENT, false,
+          reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE, reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE },
+        // [disp16], ax/al (direct address rather than [bp]):
+        { 0x06, NO_DISPLACEMENT, 2, BP_DISPLACEMENT, true,
+          reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE, reg::SOURCE_INDEX, reg::DX_REGISTER, reg::HIGH_BYTE },
+        // [disp16], bx/bl:
+        { 0x1E, NO_DISPLACEMENT, 2, BP_DISPLACEMENT, true,
+          reg::BX_REGISTER, reg::BX_REGISTER, reg::LOW_BYTE, reg::SOURCE_INDEX, reg::DX_REGISTER, reg::HIGH_BYTE },
+        // [si], si/dh:
+        { 0x34, NO_DISPLACEMENT, 0, SI_DISPLACEMENT, false,
+          reg::SOURCE_INDEX, reg::DX_REGISTER, reg::HIGH_BYTE, reg::STACK_POINTER, reg::AX_REGISTER, reg::HIGH_BYTE },
+        // [bx+disp8], ax/al:
+        { 0x47, BYTE_DISPLACEMENT, 1, BX_DISPLACEMENT, true,
+          reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE, reg::DESTINATION_INDEX, reg::BX_REGISTER, reg::HIGH_BYTE },
+        // [bp+disp8], dx/dl:
+        { 0x56, BYTE_DISPLACEMENT, 1, BP_DISPLACEMENT, true,
+          reg::DX_REGISTER, reg::DX_REGISTER, reg::LOW_BYTE, reg::SOURCE_INDEX, reg::DX_REGISTER, reg::HIGH_BYTE },
+        // [bp+disp16], ax/al:
+        { 0x86, WORD_DISPLACEMENT, 2, BP_DISPLACEMENT, true,
+          reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE, reg::SOURCE_INDEX, reg::DX_REGISTER, reg::HIGH_BYTE },
+        // [bp+di+disp16], bp/ch:
+        { 0xAB, WORD_DISPLACEMENT, 2, BP_DI_DISPLACEMENT, true,
+          reg::BASE_POINTER, reg::CX_REGISTER, reg::HIGH_BYTE, reg::BX_REGISTER, reg::BX_REGISTER, reg::LOW_BYTE },
+        // ax/al, ax/al:
+        { 0xC0, REGISTER_ADDRESSING_MODE, 0, BX_SI_DISPLACEMENT, false,
+          reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE, reg::AX_REGISTER, reg::AX_REGISTER, reg::LOW_BYTE },
+        // bp/ch, sp/ah:
+        { 0xE5, REGISTER_ADDRESSING_MODE, 0, DI_DISPLACEMENT, false,
+          reg::STACK_POINTER, reg::AX_REGISTER, reg::HIGH_BYTE, reg::BASE_POINTER, reg::CX_REGISTER, reg::HIGH_BYTE },
+        // di/bh, di/bh:
+        { 0xFF, REGISTER_ADDRESSING_MODE, 0, BX_DISPLACEMENT, false,
+          reg::DESTINATION_INDEX, reg::BX_REGISTER, reg::HIGH_BYTE, reg::DESTINATION_INDEX, reg::BX_REGISTER,
+          reg::HIGH_BYTE }
+    };
+
+    /**
+     * Compare the MOD-REG-R/M table entries of representative bytes against the expected properties above (rather than
+     * against the decoding functions that generate the tables).
+     */
+    constexpr bool modRegRmTablesMatchExpected() {
+        for(const ExpectedModRegRm& expected : EXPECTED_MODREGRMS) {
+            ModRegRm modRegRm(expected.value);
+
+            if(modRegRm.getAddressingMode() != expected.mode ||
+               modRegRm.getDisplacementReadLength() != expected.displacementReadLength ||
+               (expected.mode != REGISTER_ADDRESSING_MODE &&
+                modRegRm.getDisplacementType() != expected.displacementType) ||
+               modRegRm.isDisplacementUsed() != expected.displacementUsed)
+                return false;
+
+            if(modRegRm.getRegisterIndexFromReg(WORD_DATA_SIZE) != expected.wordReg ||
+               modRegRm.getRegisterPartFromReg(WORD_DATA_SIZE) != reg::FULL_WORD ||
+               modRegRm.getRegisterIndexFromRm(WORD_DATA_SIZE) != expected.wordRm ||
+               modRegRm.getRegisterPartFromRm(WORD_DATA_SIZE) != reg::FULL_WORD ||
+               modRegRm.getRegisterIndexFromReg(BYTE_DATA_SIZE) != expected.byteReg ||
+               modRegRm.getRegisterPartFromReg(BYTE_DATA_SIZE) != expected.byteRegPart ||
+               modRegRm.getRegisterIndexFromRm(BYTE_DATA_SIZE) != expected.byteRm ||
+               modRegRm.getRegisterPartFromRm(BYTE_DATA_SIZE) != expected.byteRmPart)
+                return false;
+        }
+
+        return true;
+    }
+
+    static_assert(modRegRmTablesMatchExpected(), "MOD-REG-R/M tables do not match the expected properties.");
+}
 
 TEST_CASE("Test CPU instruction representation.", "[emu][cpu][instructions]") {
     using namespace emu::cpu;
@@ -79,6 +166,37 @@ TEST_CASE("Test CPU instruction representation.", "[emu][cpu][instructions]") {
         }
     }
 
+    SECTION("Test MOD-REG-R/M table entries.") {
+        static_assert(instr::ModRegRm(0b11110000).getRegisterIndexFromReg(instr::BYTE_DATA_SIZE) == reg::DX_REGISTER);
+        static_assert(instr::ModRegRm(0b11110000).getRegisterPartFromReg(instr::BYTE_DATA_SIZE) == reg::HIGH_BYTE);
+        static_assert(instr::ModRegRm(0b11110000).getRegisterIndexFromReg(instr::WORD_DATA_SIZE) == reg::SOURCE_INDEX);
+        static_assert(instr::ModRegRm(0b01000110).getDisplacementReadLength() == 1);
+
+        REQUIRE(instr::MODREGRM_TABLES[instr::WORD_DATA_SIZE][0b10000111].addressingMode == instr::WORD_DISPLACEMENT);
+        REQUIRE(instr::MODREGRM_TABLES[instr::BYTE_DATA_SIZE][0b11000111].rmPart == reg::HIGH_BYTE);
+    }
+
+    SECTION("Test opcode table entries.") {
+        static_assert(instr::OPCODE_TABLE[0x01].handler ==
+                      instr::getEGHandler(false, instr::ADD_FUNCTION, instr::WORD_DATA_SIZE, instr::REG_IS_SOURCE));
+        static_assert(instr::OPCODE_TABLE[0x01].memoryHandler ==
+                      instr::getEGHandler(true, instr::ADD_FUNCTION, instr::WORD_DATA_SIZE, instr::REG_IS_SOURCE));
+        static_assert(instr::OPCODE_TABLE[0x02].handler ==
+                      instr::getEGHandler(false, instr::ADD_FUNCTION, instr::BYTE_DATA_SIZE, instr::REG_IS_DESTINATION));
+        static_assert(instr::OPCODE_TABLE[0x3B].handler ==
+                      instr::getEGHandler(false, instr::CMP_FUNCTION, instr::WORD_DATA_SIZE, instr::REG_IS_DESTINATION));
+        static_assert(instr::OPCODE_TABLE[0x04].handler == instr::INVALID_HANDLER); // ADD AL, Ib (not E, G)
+        static_assert(instr::isEGRegisterHandler(instr::OPCODE_TABLE[0x28].handler));
+        static_assert(!instr::isEGRegisterHandler(instr::OPCODE_TABLE[0x28].memoryHandler));
+        static_assert(instr::OPCODE_TABLE[0x01].hasModRegRm);
+
+        REQUIRE(instr::OPCODE_TABLE[0x55].handler == instr::PUSH_REGISTER_HANDLER);
+        REQUIRE_FALSE(instr::OPCODE_TABLE[0x55].hasModRegRm);
+        REQUIRE(instr::OPCODE_TABLE[0x5F].handler == instr::POP_REGISTER_HANDLER);
+        REQUIRE(instr::OPCODE_TABLE[0xF4].handler == instr::HALT_HANDLER);
+        REQUIRE(instr::OPCODE_TABLE[0x0F].handler == instr::INVALID_HANDLER);
+    }
+
     SECTION("Test immediate instruction value representation.") {
         std::vector<u8> immediateData = { 0xAA, 0xBB };
         instr::Immediate immediate(immediateData);
@@ -86,6 +204,12 @@ TEST_CASE("Test CPU instruction representation.", "[emu][cpu][instructions]") {
         REQUIRE(immediate.getRawData() == immediateData);
         REQUIRE(immediate.getByteValue() == 0xAA);
         REQUIRE(immediate.getWordValue() == 0xBBAA);
+        REQUIRE(immediate.getSignExtendedValue() == 0xBBAA);
+
+        static_assert(instr::Immediate(0x80).getSignExtendedValue() == 0xFF80);
+        static_assert(instr::Immediate(0x7F).getSignExtendedValue() == 0x007F);
+        static_assert(instr::Immediate(0x80).getValueUsingDataSize(instr::WORD_DATA_SIZE) == 0x0080);
+        static_assert(std::is_trivially_copyable_v<instr::Immediate>);
     }
 
     SECTION("Test displacement instruction value representation.") {
@@ -93,5 +217,9 @@ TEST_CASE("Test CPU instruction representation.", "[emu][cpu][instructions]") {
         instr::Displacement displacement(displacementData);
 
         REQUIRE(displacement.getRawData() == displacementData);
+        REQUIRE(displacement.getValueUsingAddressingMode(instr::BYTE_DISPLACEMENT) == 0xFFAA); // Sign-extended.
+
+        static_assert(instr::Displacement(0x10, 0x80).getValueUsingAddressingMode(instr::WORD_DISPLACEMENT) == 0x8010);
+        static_assert(instr::Displacement(0x10).getValueUsingAddressingMode(instr::NO_DISPLACEMENT) == 0);
     }
 }
\ No newline at end of file
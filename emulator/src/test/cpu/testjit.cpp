@@ -0,0 +1,110 @@
+#include "catch.hpp"
+#include "primitives.hpp"
+#include "cpustate.hpp"
+#include "emu/cpu/intel8086.hpp"
+#include "emu/cpu/jit/translator.hpp"
+
+TEST_CASE("Test translation of hot blocks into native code.", "[emu][cpu][jit]") {
+    using namespace emu;
+
+    Mem memory(0xFF), interpretedMemory(0xFF);
+
+    cpu::Intel8086 cpu, interpreted;
+
+    if(!cpu.setJitEnabled(true)) {
+        WARN("Translation into native code is not supported on this platform.");
+        return;
+    }
+
+    auto runToHalt = [](cpu::Intel8086& c, Mem& m) {
+        c.halted = false;
+        c.performRelativeJump(0);
+
+        while(!c.halted) REQUIRE(c.executeBlock(m).success);
+    };
+
+    // Load the same program into both memories and run it to completion repeatedly, comparing the results each time:
+    auto runAndCompare = [&](const std::vector<MemValue>& program, unsigned int times) {
+        memory.write(0, program);
+        interpretedMemory.write(0, program);
+
+        for(unsigned int i = 0; i < times; i++) {
+            runToHalt(cpu, memory);
+            runToHalt(interpreted, interpretedMemory);
+
+            test::requireSameState(cpu, interpreted);
+            REQUIRE(memory.read(0, memory.size) == interpretedMemory.read(0, interpretedMemory.size));
+        }
+    };
+
+    test::initialiseRegisters(cpu);
+    test::initialiseRegisters(interpreted);
+
+    SECTION("Test translated code against the interpreter.") {
+        // push ax, push bx, add ax, bx, add cl, ch, add dh, bl, pop cx, pop dx, add [si], ax, hlt
+        std::vector<MemValue> program = { 0x50, 0x53, 0x01, 0xD8, 0x00, 0xE9, 0x02, 0xF3, 0x59, 0x5A, 0x01, 0x04, 0xF4 };
+        runAndCompare(program, 40);
+
+        REQUIRE(cpu.getTranslator()->getTranslationCount() == 1);
+        REQUIRE(cpu.getTranslator()->getNativeExecutionCount() == 40 - cpu::jit::Translator::HOT_THRESHOLD + 1);
+    }
+
+    SECTION("Test translated E, G arithmetic/logic instructions against the interpreter.") {
+        std::vector<MemValue> program;
+
+        for(u8 opcode = 0x00; opcode < 0x40; opcode++) {
+            if((opcode & 0b111) > 0b011 || (opcode >= 0x10 && opcode < 0x20)) continue; // Skip ADC/SBB and non-E, G.
+
+            program.push_back(opcode);
+            program.push_back(static_cast<u8>(0b11000000 | ((opcode * 5) & 0b111111)));
+        }
+
+        program.push_back(0x11); // adc ax, bx (ends translation)
+        program.push_back(0xD8);
+        program.push_back(0xF4);
+
+        runAndCompare(program, 40);
+
+        REQUIRE(cpu.getTranslator()->getNativeExecutionCount() > 0);
+    }
+
+    SECTION("Test translated code that modifies its own block.") {
+        // push ax, add cx, bx, hlt
+        std::vector<MemValue> program = { 0x50, 0x01, 0xD9, 0xF4 };
+        runAndCompare(program, 20);
+
+        REQUIRE(cpu.getTranslator()->getNativeExecutionCount() > 0);
+
+        // Push 0xF4C8 over the ADD such that it becomes add ax, cx followed by hlt:
+        for(auto* c : { &cpu, &interpreted }) {
+            c->generalRegisters.set(cpu::reg::STACK_POINTER, 4);
+            c->generalRegisters.set(cpu::reg::AX_REGISTER, 0xF4C8);
+        }
+
+        runToHalt(cpu, memory);
+        runToHalt(interpreted, interpretedMemory);
+
+        test::requireSameState(cpu, interpreted);
+        REQUIRE(memory.read(0, memory.size) == interpretedMemory.read(0, interpretedMemory.size));
+        REQUIRE(memory.read(2) == 0xC8);
+    }
+
+    SECTION("Test translated stack operations on memory that may not be accessed directly.") {
+        // push ax, push bx, pop cx, hlt
+        std::vector<MemValue> program = { 0x50, 0x53, 0x59, 0xF4 };
+        auto snapshot = memory.createSnapshot(); // Writes must go through Memory::write to copy pages first.
+        interpretedMemory.createSnapshot();
+
+        runAndCompare(program, 20);
+
+        REQUIRE(cpu.getTranslator()->getNativeExecutionCount() > 0);
+
+        REQUIRE(memory.restoreSnapshot(snapshot));
+        REQUIRE(memory.readWord(0xA8) == 0);
+    }
+
+    SECTION("Test disabling translation.") {
+        REQUIRE_FALSE(cpu.setJitEnabled(false));
+        REQUIRE(cpu.getTranslator() == nullptr);
+    }
+}
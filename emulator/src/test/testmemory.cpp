@@ -1,4 +1,6 @@
 #include "catch.hpp"
+#include <cstdio>
+#include <fstream>
 #include <vector>
 #include "primitives.hpp"
 #include "emu/memory.hpp"
@@ -42,10 +44,369 @@ TEST_CASE("Test emulator memory.", "[emu][memory]") {
     SECTION("Test filling of all memory.") {
         constexpr Value value = 456;
 
+        for(Address addr = 0; addr < memory.size; addr++) {
+            REQUIRE(memory.read(addr) == 0); // Memory is initially zeroed.
+        }
+
+        u32 generation = memory.getGeneration(0, memory.size - 1);
         memory.fill(value);
+        REQUIRE(memory.getGeneration(0, memory.size - 1) != generation);
 
         for(Address addr = 0; addr < memory.size; addr++) {
             REQUIRE(memory.read(addr) == value);
         }
+
+        memory.fill();
+
+        for(Address addr = 0; addr < memory.size; addr++) {
+            REQUIRE(memory.read(addr) == 0);
+        }
+    }
+
+    SECTION("Test wrapped and mirrored access modes.") {
+        memory.setAccessMode(Memory::WRAPPED_ACCESS, 0x1F);
+
+        memory.write(0x23, 789); // Masked to 0x03.
+        REQUIRE(memory.read(0x03) == 789);
+        REQUIRE(memory.getFaultCount() == 0);
+
+        REQUIRE_NOTHROW(memory.write(0x10, 789));
+        REQUIRE(memory.read(0x10) == 0);
+        REQUIRE(memory.getFaultCount() == 2);
+        REQUIRE(memory.getLastFaultAddress() == 0x10);
+
+        memory.setAccessMode(Memory::MIRRORED_ACCESS, 0x1F);
+
+        REQUIRE(memory.read(memory.size + 0x03) == 789);
+
+        u32 generation = memory.getGeneration(0x03, 0x03);
+        memory.write(memory.size + 0x03, 123);
+        REQUIRE(memory.read(0x03) == 123);
+        REQUIRE(memory.getGeneration(memory.size + 0x03, memory.size + 0x03) != generation);
+        REQUIRE(memory.getFaultCount() == 2);
+    }
+
+    SECTION("Test loading of files by mapping them into memory.") {
+        using ByteMemory = emu::Memory<u8, Address>;
+
+        const std::string path = "wired86_testimage.bin";
+        const Address pageSize = static_cast<Address>(emu::HostMemory::getPageSize());
+
+        std::vector<u8> image(pageSize * 2 + 100); // Two whole pages and a partial page.
+        for(Address addr = 0; addr < image.size(); addr++) image[addr] = static_cast<u8>(addr * 7);
+
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(image.data()), image.size());
+
+        auto requireImageAt = [&image](const ByteMemory& mem, Address offset) {
+            for(Address addr = 0; addr < image.size(); addr++) REQUIRE(mem.read(offset + addr) == image[addr]);
+        };
+
+        ByteMemory rom(pageSize * 4);
+        u32 generation = rom.getGeneration(0, rom.size - 1);
+
+        REQUIRE(rom.mapFromFile(path, 0, true));
+        requireImageAt(rom, 0);
+        REQUIRE(rom.getGeneration(0, rom.size - 1) != generation);
+
+        rom.write(5, 0xAA); // Writes to read-only data are ignored.
+        rom.write(pageSize * 2 + 50, 0xAA);
+        REQUIRE(rom.isReadOnly(pageSize * 2 + 99));
+        REQUIRE_FALSE(rom.isReadOnly(pageSize * 2 + 100));
+        requireImageAt(rom, 0);
+
+        rom.write(pageSize * 3, 0xAA);
+        REQUIRE(rom.read(pageSize * 3) == 0xAA);
+
+        // Loading over read-only data leaves it unmodified (it may not even be writable by the host):
+        const std::string otherPath = "wired86_testimage_other.bin";
+        std::vector<u8> other(pageSize * 3, 0xCC);
+        std::ofstream(otherPath, std::ios::binary).write(reinterpret_cast<const char*>(other.data()), other.size());
+
+        REQUIRE(rom.loadFromFile(otherPath, 0));
+        REQUIRE(rom.mapFromFile(otherPath, 0));
+        requireImageAt(rom, 0);
+        REQUIRE(rom.read(pageSize * 2 + 100) == 0xCC);
+        REQUIRE(rom.read(pageSize * 3) == 0xAA);
+
+        rom.fill(0xBB); // Read-only data is left unmodified.
+        requireImageAt(rom, 0);
+        REQUIRE(rom.read(pageSize * 2 + 100) == 0xBB);
+        REQUIRE(rom.read(rom.size - 1) == 0xBB);
+
+        ByteMemory ram(pageSize * 4);
+        REQUIRE(ram.mapFromFile(path, pageSize));
+        requireImageAt(ram, pageSize);
+
+        ram.write(pageSize, 0xAA); // Writable mappings are private to the memory.
+        REQUIRE(ram.read(pageSize) == 0xAA);
+
+        ram.fill();
+        REQUIRE(ram.read(pageSize) == 0);
+        REQUIRE(ram.read(pageSize + 1) == 0);
+
+        ByteMemory copy(pageSize * 4);
+        REQUIRE(copy.mapFromFile(path, 3)); // Offset not page aligned so falls back on copying.
+        requireImageAt(copy, 3);
+
+        // Host memory behind devices is left unmodified by loading too:
+        struct NullDevice : ByteMemory::Device {
+            u8 read(Address) override { return 0; }
+            void write(Address, u8) override {}
+        } device;
+
+        auto isInDevice = [](Address addr) { return addr >= ByteMemory::PAGE_SIZE && addr < ByteMemory::PAGE_SIZE * 2; };
+
+        ByteMemory devices(pageSize * 4);
+        devices.fill(0x11);
+        REQUIRE(devices.attachDevice(device, ByteMemory::PAGE_SIZE, ByteMemory::PAGE_SIZE));
+        REQUIRE(devices.mapFromFile(otherPath, 0)); // Device follows the offset so the file is copied instead.
+
+        for(Address addr = 0; addr < other.size(); addr++) {
+            if(!isInDevice(addr)) REQUIRE(devices.read(addr) == 0xCC);
+        }
+        REQUIRE(devices.read(static_cast<Address>(other.size())) == 0x11);
+
+        REQUIRE(devices.detachDevice(device));
+        for(Address addr = ByteMemory::PAGE_SIZE; addr < ByteMemory::PAGE_SIZE * 2; addr++) {
+            REQUIRE(devices.read(addr) == 0x11);
+        }
+
+        // Mapping is refused while snapshots exist such that the previous contents of memory are saved:
+        ByteMemory snapshotted(pageSize * 4);
+        snapshotted.fill(0x22);
+        auto snapshot = snapshotted.createSnapshot();
+
+        REQUIRE(snapshotted.mapFromFile(path, pageSize));
+        requireImageAt(snapshotted, pageSize);
+        REQUIRE(snapshotted.read(pageSize - 1) == 0x22);
+        REQUIRE(snapshotted.read(pageSize + static_cast<Address>(image.size())) == 0x22);
+
+        REQUIRE(snapshotted.restoreSnapshot(snapshot));
+        for(Address addr = 0; addr < snapshotted.size; addr++) REQUIRE(snapshotted.read(addr) == 0x22);
+
+        std::remove(otherPath.c_str());
+
+        std::remove(path.c_str());
+        REQUIRE_FALSE(copy.mapFromFile(path));
+    }
+
+    SECTION("Test copy-on-write snapshots.") {
+        using ByteMemory = emu::Memory<u8, Address>;
+
+        ByteMemory mem(ByteMemory::PAGE_SIZE * 8);
+        const Address page = ByteMemory::PAGE_SIZE;
+
+        mem.write(0, 1);
+        auto first = mem.createSnapshot();
+
+        mem.write(0, 2);
+        mem.write(page * 3, 2);
+        auto second = mem.createSnapshot();
+
+        mem.write(page * 3, 3);
+        mem.write(page * 5 + 10, 3);
+        mem.writeWord(page * 6 - 1, 0x0303); // Straddles two pages.
+
+        u32 generation = mem.getGeneration(0, mem.size - 1);
+
+        REQUIRE(mem.restoreSnapshot(second));
+        REQUIRE(mem.getGeneration(0, mem.size - 1) != generation);
+        REQUIRE(mem.read(0) == 2);
+        REQUIRE(mem.read(page * 3) == 2);
+        REQUIRE(mem.read(page * 5 + 10) == 0);
+        REQUIRE(mem.readWord(page * 6 - 1) == 0);
+
+        mem.write(page * 3, 4);
+        REQUIRE(mem.restoreSnapshot(second)); // Snapshots may be restored repeatedly.
+        REQUIRE(mem.read(page * 3) == 2);
+
+        REQUIRE(mem.restoreSnapshot(first));
+        REQUIRE(mem.read(0) == 1);
+        REQUIRE(mem.read(page * 3) == 0);
+        REQUIRE_FALSE(mem.restoreSnapshot(second)); // Released as taken after the restored snapshot.
+
+        // Releasing a snapshot hands its pages to the previous snapshot:
+        mem.write(page * 2, 5);
+        auto third = mem.createSnapshot();
+        mem.write(page * 2, 6);
+        mem.write(page * 4, 6);
+
+        REQUIRE(mem.releaseSnapshot(third));
+        REQUIRE(mem.getSnapshotCount() == 1);
+
+        mem.write(page * 4, 7);
+        REQUIRE(mem.restoreSnapshot(first));
+        REQUIRE(mem.read(page * 2) == 0);
+        REQUIRE(mem.read(page * 4) == 0);
+        REQUIRE(mem.read(0) == 1);
+
+        // Only the writable part of a page that is partly read-only is restored:
+        const std::string path = "wired86_testsnapshotrom.bin";
+        std::vector<u8> image(page / 2, 0xEE);
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(image.data()), image.size());
+
+        ByteMemory partial(page * 2);
+        partial.write(page / 2, 1);
+        REQUIRE(partial.mapFromFile(path, 0, true));
+        std::remove(path.c_str());
+
+        auto fourth = partial.createSnapshot();
+        partial.write(page / 2, 2);
+        partial.write(page - 1, 2);
+        partial.write(page / 2 - 1, 2); // Ignored as read-only.
+
+        u32 romGeneration = partial.getGeneration(0, page / 2 - 1);
+
+        REQUIRE(partial.restoreSnapshot(fourth));
+        REQUIRE(partial.read(page / 2) == 1);
+        REQUIRE(partial.read(page - 1) == 0);
+        REQUIRE(partial.read(page / 2 - 1) == 0xEE);
+        REQUIRE(partial.getGeneration(0, page / 2 - 1) == romGeneration); // Unchanged data is not touched.
+    }
+
+    SECTION("Test incremental saving of modified pages to delta files.") {
+        using ByteMemory = emu::Memory<u8, Address>;
+
+        const std::string path = "wired86_testdelta.bin";
+        std::remove(path.c_str());
+
+        const Address page = ByteMemory::PAGE_SIZE;
+        ByteMemory mem(page * 4 + 100); // Final page is partial.
+
+        ByteMemory::SaveToken token = ByteMemory::INITIAL_SAVE_TOKEN;
+
+        REQUIRE(mem.isPageModified(0, token)); // All pages must be written in the first version.
+        REQUIRE(mem.saveDeltaToFile(path, token)); // Version 0.
+        REQUIRE_FALSE(mem.isPageModified(0, token));
+
+        auto fileSize = [](const std::string& file) {
+            return std::ifstream(file, std::ios::binary | std::ios::ate).tellg();
+        };
+        auto initialSize = fileSize(path);
+
+        mem.write(page + 1, 1);
+        mem.writeWord(page * 4 - 1, 0x0202); // Straddles two pages.
+        REQUIRE(mem.isPageModified(1, token));
+        REQUIRE_FALSE(mem.isPageModified(2, token));
+        REQUIRE(mem.isPageModified(3, token));
+        REQUIRE(mem.isPageModified(4, token));
+        REQUIRE(mem.saveDeltaToFile(path, token)); // Version 1.
+        REQUIRE(fileSize(path) - initialSize < page * 3 + 100); // Only modified pages were appended.
+
+        mem.write(page + 1, 3);
+        mem.write(page * 4 + 99, 3);
+        REQUIRE(mem.saveDeltaToFile(path, token)); // Version 2.
+
+        ByteMemory loaded(mem.size);
+        ByteMemory::SaveToken loadedToken;
+
+        REQUIRE(loaded.loadDeltaFromFile(path, loadedToken));
+        for(Address addr = 0; addr < mem.size; addr++) REQUIRE(loaded.read(addr) == mem.read(addr));
+        REQUIRE_FALSE(loaded.isPageModified(1, loadedToken)); // Matches the latest version.
+        REQUIRE(loaded.isPageModified(1, ByteMemory::INITIAL_SAVE_TOKEN));
+
+        REQUIRE(loaded.loadDeltaFromFile(path, loadedToken, 1));
+        REQUIRE(loaded.read(page + 1) == 1);
+        REQUIRE(loaded.readWord(page * 4 - 1) == 0x0202);
+        REQUIRE(loaded.read(page * 4 + 99) == 0);
+        REQUIRE(loadedToken == ByteMemory::INITIAL_SAVE_TOKEN); // Differs from the latest version so must all be saved.
+
+        REQUIRE(loaded.loadDeltaFromFile(path, loadedToken, 0));
+        REQUIRE(loaded.read(page + 1) == 0);
+
+        REQUIRE_FALSE(loaded.loadDeltaFromFile(path, loadedToken, 3)); // No such version.
+        REQUIRE(loaded.read(page + 1) == 0);
+
+        // Saving to a second file does not affect which pages are saved to the first:
+        const std::string otherPath = "wired86_testdelta_other.bin";
+        std::remove(otherPath.c_str());
+
+        ByteMemory::SaveToken otherToken = ByteMemory::INITIAL_SAVE_TOKEN;
+        mem.write(page * 2, 4);
+        REQUIRE(mem.saveDeltaToFile(otherPath, otherToken));
+        REQUIRE(mem.isPageModified(2, token));
+        REQUIRE_FALSE(mem.isPageModified(2, otherToken));
+
+        auto previousSize = fileSize(path);
+        REQUIRE(mem.saveDeltaToFile(path, token)); // Version 3.
+        REQUIRE(fileSize(path) - previousSize > page); // Page 2 was saved.
+
+        REQUIRE(loaded.loadDeltaFromFile(path, loadedToken));
+        REQUIRE(loaded.read(page * 2) == 4);
+        REQUIRE(loaded.loadDeltaFromFile(otherPath, loadedToken));
+        REQUIRE(loaded.read(page * 2) == 4);
+
+        std::remove(otherPath.c_str());
+
+        ByteMemory other(page * 2);
+        REQUIRE_FALSE(other.loadDeltaFromFile(path, loadedToken)); // Memory size differs.
+        REQUIRE_FALSE(other.saveDeltaToFile(path, loadedToken));
+
+        std::remove(path.c_str());
+        REQUIRE_FALSE(loaded.loadDeltaFromFile(path, loadedToken));
+    }
+
+    SECTION("Test attaching devices to regions of memory.") {
+        using ByteMemory = emu::Memory<u8, Address>;
+
+        struct TestDevice : ByteMemory::Device {
+            u8 read(Address address) override { reads++; return static_cast<u8>(address + 0x80); }
+            void write(Address address, u8 value) override { lastAddress = address; lastValue = value; }
+
+            unsigned int reads = 0;
+            Address lastAddress = 0;
+            u8 lastValue = 0;
+        };
+
+        const Address page = ByteMemory::PAGE_SIZE;
+        ByteMemory mem(page * 3 + 100); // Final page is partial.
+        TestDevice device, other;
+
+        mem.write(page, 1);
+        REQUIRE(mem.attachDevice(device, page, page));
+
+        REQUIRE(mem.read(page) == 0x80); // Addresses are relative to the start of the region.
+        REQUIRE(mem.read(page * 2 - 1) == static_cast<u8>(page - 1 + 0x80));
+
+        u32 generation = mem.getGeneration(0, mem.size - 1);
+        mem.write(page + 5, 9);
+        REQUIRE(device.lastAddress == 5);
+        REQUIRE(device.lastValue == 9);
+        REQUIRE(mem.getGeneration(0, mem.size - 1) == generation);
+
+        mem.write(page - 1, 0x12); // Words and buffers spanning RAM and device pages.
+        REQUIRE(mem.readWord(page - 1) == 0x8012);
+        u8 buffer[3];
+        REQUIRE(mem.readInto(page - 1, buffer, 3) == 3);
+        REQUIRE(buffer[0] == 0x12);
+        REQUIRE(buffer[2] == 0x81);
+        mem.writeWord(page * 2 - 1, 0x3456);
+        REQUIRE(device.lastValue == 0x56);
+        REQUIRE(mem.read(page * 2) == 0x34);
+
+        REQUIRE_FALSE(mem.attachDevice(other, page + 1, page)); // Not page aligned.
+        REQUIRE_FALSE(mem.attachDevice(other, page * 2, page + 1)); // Not whole pages.
+        REQUIRE_FALSE(mem.attachDevice(other, 0, page * 2)); // Overlaps a device.
+        REQUIRE(mem.attachDevice(other, page * 3, 100)); // Partial final page.
+        REQUIRE(mem.read(page * 3 + 99) == 99 + 0x80);
+        REQUIRE(other.reads == 1);
+
+        mem.writeWord(page * 2 + 10, 0x789A); // Words within RAM pages while devices are attached.
+        REQUIRE(mem.readWord(page * 2 + 10) == 0x789A);
+        REQUIRE(mem.readInto(page * 2 - 1, buffer, 3) == 3);
+        REQUIRE(buffer[0] == static_cast<u8>(page - 1 + 0x80));
+
+        mem.fill(0x55); // Leaves host memory behind devices unmodified.
+        REQUIRE(mem.read(0) == 0x55);
+        REQUIRE(mem.read(page * 2 + 10) == 0x55);
+        mem.fill();
+        REQUIRE(mem.read(page * 2 + 10) == 0);
+
+        REQUIRE(mem.detachDevice(device));
+        REQUIRE_FALSE(mem.detachDevice(device));
+        REQUIRE(mem.read(page) == 1); // Host memory left unmodified.
+        mem.write(page, 2);
+        REQUIRE(mem.read(page) == 2);
+        REQUIRE(mem.readWord(page * 3 + 98) == 0xE3E2);
     }
 }
\ No newline at end of file